@@ -13,11 +13,29 @@ OSSIA {
 	*access_mode { ^OSSIA_access_mode }
 	*bounding_mode { ^OSSIA_bounding_mode }
 
+	*filter { |tags, type, access, unit, critical, path|
+		^OSSIA_ExploreFilter(tags, type, access, unit, critical, path)
+	}
+
+	*template { ^OSSIA_Template() }
+
+	// tracks allocations per primitive, requires a build with OSSIA_ALLOC_DEBUG
+	*allocDebug_ { |aBool|
+		_OSSIA_AllocDebugSet
+		^this.primitiveFailed
+	}
+
+	// returns [primitive, calls, allocations, bytes] for each primitive called while tracking
+	*allocStats { |reset = false|
+		_OSSIA_AllocDebugReport
+		^this.primitiveFailed
+	}
+
 	*vec2f { |v1 = 0.0, v2 = 0.0| ^OSSIA_vec2f(v1, v2) }
 	*vec3f { |v1 = 0.0, v2 = 0.0, v3 = 0.0| ^OSSIA_vec3f(v1, v2, v3) }
 	*vec4f { |v1 = 0.0, v2 = 0.0, v3 = 0.0, v4 = 0.0| ^OSSIA_vec4f(v1, v2, v3, v4) }
 
-	*device  { |name| ^OSSIA_Device(name) }
+	*device  { |name, pooled = false| ^OSSIA_Device(name, pooled) }
 	*node { |parent_node, name| ^OSSIA_Node(parent_node, name) }
 
 	*parameter { |parent_node, name, type, domain, default_value, bounding_mode = 'free',
@@ -66,6 +84,70 @@ OSSIA_domain[slot]
 	}
 }
 
+OSSIA_Template
+{
+	var m_entries, m_id;
+
+	*new { ^super.new.init }
+
+	init { m_entries = [] }
+
+	node { |name|
+		this.free();
+		m_entries = m_entries.add([name]);
+	}
+
+	parameter { |name, type, domain, default_value, bounding_mode = 'free',
+		critical = false, repetition_filter = false, unit|
+		this.free();
+		m_entries = m_entries.add([name, type, domain, default_value,
+			bounding_mode, critical, repetition_filter, unit]);
+	}
+
+	// creates count instances named after name ('%' is replaced by the index)
+	// under each of the parents, or applies the template directly to the parents if name is nil
+	// returns the instances' root nodes
+	instantiate { |parents, name, count = 1|
+		if(m_id.isNil) { this.pyrCtor(m_entries) };
+		^this.pyrApply(parents.asArray, name, count).collect({|handle|
+			OSSIA_Node.newFromChild.handleInit(handle)
+		});
+	}
+
+	free {
+		m_id !? { this.pyrFree() };
+	}
+
+	pyrCtor { |entries|
+		_OSSIA_TemplateInstantiate
+		^this.primitiveFailed
+	}
+
+	pyrApply { |parents, name, count|
+		_OSSIA_TemplateApply
+		^this.primitiveFailed
+	}
+
+	pyrFree {
+		_OSSIA_TemplateFree
+		^this.primitiveFailed
+	}
+}
+
+OSSIA_ExploreFilter
+{
+	var <>tags, <>type, <>access, <>unit, <>critical, <>path;
+
+	*new { |tags, type, access, unit, critical, path|
+
+		if((tags.notNil) && (tags.isArray.not)) {
+			Error("tags argument should be an array").throw;
+		};
+
+		^super.newCopyArgs(tags, type, access, unit, critical, path);
+	}
+}
+
 OSSIA_vec2f : OSSIA_FVector
 {
 	*new {|v1 = 0.0, v2 = 0.0|
@@ -132,7 +214,7 @@ OSSIA_bounding_mode {
 
 OSSIA_Node {
 
-	var m_ptr_data;
+	var m_handle;
 
 	*new { |parent, name|
 		^super.new.nodeCtor(parent, name);
@@ -142,6 +224,8 @@ OSSIA_Node {
 		^super.new
 	}
 
+	handleInit { |handle| m_handle = handle }
+
 	nodeCtor { |parent, name|
 		_OSSIA_InstantiateNode
 		^this.primitiveFailed
@@ -163,24 +247,8 @@ OSSIA_Node {
 	}
 
 	snapshot { |... exclude|
-		var exp = this.explore(false, true);
-		var res = [];
-
-		exp.do({|item|
-			var unique = item[0].split($/).last ++ "_" ++ item[1];
-			res = res.add(unique.asSymbol);
-			res = res.add(item[2]);
-		});
-
-		if(exclude.notEmpty)
-		{
-			exclude.do({|item|
-				var index = res.indexOf(item.sym);
-				2.do({ res.removeAt(index) });
-			});
-		};
-
-		^res
+		_OSSIA_NodeSnapshot
+		^this.primitiveFailed
 	}
 
 	tree { |with_attributes = false, parameters_only = false|
@@ -196,11 +264,21 @@ OSSIA_Node {
 
 	}
 
-	explore { |with_attributes = true, parameters_only = false|
+	explore { |with_attributes = true, parameters_only = false, depth, offset = 0, limit, filter|
 		_OSSIA_NodeExplore
 		^this.primitiveFailed
 	}
 
+	explore_cursor { |with_attributes = true, parameters_only = false, depth, filter|
+		^OSSIA_ExploreCursor(this, with_attributes, parameters_only, depth, filter)
+	}
+
+	// returns [paths, handles, values, types], as parallel arrays
+	explore_columns { |parameters_only = false, columns, filter|
+		_OSSIA_NodeExploreColumns
+		^this.primitiveFailed
+	}
+
 	is_disabled {
 		_OSSIA_NodeGetDisabled
 		^this.primitiveFailed
@@ -274,6 +352,27 @@ OSSIA_Node {
 		path ?? { Dialog.savePanel({|p| this.pyrPresetSave(p)}); };
 	}
 
+	// returns [path, value...] for every parameter in source that differs from the live tree
+	// source is a preset file path, or an array such as the one returned by .state
+	diff { |source, apply = false|
+		_OSSIA_NodeDiff
+		^this.primitiveFailed
+	}
+
+	recall { |source| ^this.diff(source, true) }
+
+	state {
+		var columns = this.explore_columns(true, ['path', 'value']);
+		^[columns[0], columns[2]].flop.flatten(1)
+	}
+
+	footprint { ^().putPairs(this.pyrFootprint.flatten(1)) }
+
+	pyrFootprint {
+		_OSSIA_NodeFootprint
+		^this.primitiveFailed
+	}
+
 	pyrPresetLoad { |path|
 		_OSSIA_PresetLoad
 		^this.primitiveFailed
@@ -286,21 +385,66 @@ OSSIA_Node {
 
 }
 
+OSSIA_ExploreCursor {
+
+	var m_id;
+
+	*new { |node, with_attributes = true, parameters_only = false, depth, filter|
+		^super.new.pyrCtor(node, with_attributes, parameters_only, depth, filter)
+	}
+
+	pyrCtor { |node, with_attributes, parameters_only, depth, filter|
+		_OSSIA_ExploreCursorInstantiate
+		^this.primitiveFailed
+	}
+
+	// returns the next chunk of node sheets (possibly empty when filtered), nil once the whole subtree was explored
+	next { |limit = 256|
+		_OSSIA_ExploreCursorNext
+		^this.primitiveFailed
+	}
+
+	free {
+		_OSSIA_ExploreCursorFree
+		^this.primitiveFailed
+	}
+}
+
 OSSIA_Device : OSSIA_Node {
 
-	classvar g_devices;
-	var m_semaphore;
+	classvar g_devices, g_teardowns, g_teardown_count = 0;
+	classvar g_mirror_loads, g_mirror_count = 0;
+	classvar g_zeroconf_appear, g_zeroconf_disappear;
+	var m_semaphore, m_stats_routine;
 
 	*initClass {
 		g_devices = [];
+		g_teardowns = ();
+		g_mirror_loads = ();
 		ShutDown.add({this.ossia_dtor});
 	}
 
+	// returns the cached oscquery devices, browsing goes on in the background
 	*net_explore {
 		_OSSIA_ZeroConfExplore
 		^this.primitiveFailed
 	}
 
+	*net_watch { |appear, disappear|
+		g_zeroconf_appear = appear;
+		g_zeroconf_disappear = disappear;
+		^this.net_explore;
+	}
+
+	*pvOnZeroconf { |name, host, port, appeared|
+		var zconf_array = [name, host, port];
+		if(appeared) {
+			g_zeroconf_appear.value(zconf_array);
+		} {
+			g_zeroconf_disappear.value(zconf_array);
+		};
+	}
+
 	*format_ws { |zconf_array|
 		^format("ws://%:%", zconf_array[1], zconf_array[2]);
 	}
@@ -310,29 +454,30 @@ OSSIA_Device : OSSIA_Node {
 			OSSIA_Device.format_ws(zconf_target_array), callback);
 	}
 
-	*new {|name|
+	*new {|name, pooled = false|
 
 		g_devices.do({|dev|
 			if(name == dev.name) { dev.free() };
 		});
 
-		^super.newFromChild.pyrDeviceCtor(name).stack_up();
+		^super.newFromChild.pyrDeviceCtor(name, pooled).stack_up();
 	}
 
 	stack_up { g_devices = g_devices.add(this); }
-	*ossia_dtor { "OSSIA: cleanup...".postln; g_devices.do(_.free()); }
+	// devices are destroyed in the background, so that recompiling and quitting don't block
+	*ossia_dtor { "OSSIA: cleanup...".postln; g_devices.copy.do(_.free(true)); }
 
 	//-------------------------------------------//
 	//               DEVICE CALLBACKS            //
 	//-------------------------------------------//
 
-	forkExpose { |method, vargs, callback|
+	forkExpose { |method, vargs, callback, include, exclude|
 
 		callback !? {
 			m_semaphore = Semaphore(1);
 			fork {
 				m_semaphore.wait();
-				this.exposeRedirect(method, vargs);
+				this.exposeRedirect(method, vargs, include, exclude);
 			};
 
 			fork {
@@ -343,16 +488,18 @@ OSSIA_Device : OSSIA_Node {
 		};
 
 		callback ?? {
-			this.exposeRedirect(method, vargs);
+			this.exposeRedirect(method, vargs, include, exclude);
 		};
 	}
 
-	exposeRedirect { |method, vargs|
+	// the filter applies to the protocol exposed right after it
+	exposeRedirect { |method, vargs, include, exclude|
+		this.pyrExposeFilter(include, exclude);
 		switch(method,
 			'oscqs', { this.pyrOSCQS(vargs[0], vargs[1])},
-			'oscqm', { this.pyrOSCQM(vargs[0])},
 			'minuit', { this.pyrMinuit(vargs[0], vargs[1], vargs[2])},
-			'osc', { this.pyrOSC(vargs[0], vargs[1], vargs[2])}
+			'osc', { this.pyrOSC(vargs[0], vargs[1], vargs[2], vargs[3])},
+			'local', { this.pyrLocal(vargs[0], vargs[1])}
 		);
 	}
 
@@ -360,46 +507,125 @@ OSSIA_Device : OSSIA_Node {
 	//                NEW SHORTCUTS              //
 	//-------------------------------------------//
 
-	*newOSCQueryServer { |name, osc_port = 1234, ws_port = 5678, callback|
-		^this.new(name).exposeOSCQueryServer(osc_port, ws_port, callback);
+	*newOSCQueryServer { |name, osc_port = 1234, ws_port = 5678, callback, include, exclude|
+		^this.new(name).exposeOSCQueryServer(osc_port, ws_port, callback, include, exclude);
 	}
 
-	*newOSCQueryMirror { |name, host_addr, callback|
-		^this.new(name).exposeOSCQueryMirror(host_addr, callback);
+	*newOSCQueryMirror { |name, host_addr, callback, progress, lazy = false, cache = false, include, exclude|
+		^this.new(name).exposeOSCQueryMirror(host_addr, callback, progress, lazy, cache, include, exclude);
 	}
 
-	*newMinuit { |name, remote_ip, remote_port, local_port, callback|
-		^this.new(name).exposeMinuit(remote_ip, remote_port, local_port, callback);
+	*newMinuit { |name, remote_ip, remote_port, local_port, callback, include, exclude|
+		^this.new(name).exposeMinuit(remote_ip, remote_port, local_port, callback, include, exclude);
 	}
 
-	*newOSC { |name, remote_ip, remote_port, local_port, callback|
-		^this.new(name).exposeOSC(remote_ip, remote_port, local_port, callback);
+	*newOSC { |name, remote_ip, remote_port, local_port, callback, batched = false, include, exclude|
+		^this.new(name).exposeOSC(remote_ip, remote_port, local_port, callback, batched, include, exclude);
+	}
+
+	*newLocal { |name, local_path, remote_path, callback, include, exclude|
+		^this.new(name).exposeLocal(local_path, remote_path, callback, include, exclude);
 	}
 
 	//-------------------------------------------//
 	//                   EXPOSE                  //
 	//-------------------------------------------//
 
-	exposeOSCQueryServer { |osc_port = 1234, ws_port = 5678, callback|
-		this.forkExpose('oscqs', [osc_port, ws_port], callback);
+	// every expose method takes include and exclude address patterns (a String or an Array of them):
+	// only the parameters they select are pushed to, and observed from, that protocol
+	exposeOSCQueryServer { |osc_port = 1234, ws_port = 5678, callback, include, exclude|
+		this.forkExpose('oscqs', [osc_port, ws_port], callback, include, exclude);
+	}
+
+	// connects and loads the remote namespace in the background, without blocking the interpreter
+	// progress is called with |loaded, total| node counts, callback with |success| once done
+	// lazy mirrors only create nodes when they are accessed
+	// cache (true, or a file path) keeps the namespace on disk for the next connection
+	exposeOSCQueryMirror { |host_addr, callback, progress, lazy = false, cache = false, include, exclude|
+		g_mirror_count = g_mirror_count + 1;
+		g_mirror_loads[g_mirror_count] = [callback, progress, this];
+		this.pyrExposeFilter(include, exclude);
+		this.pyrOSCQM(host_addr, g_mirror_count, lazy, OSSIA_Device.cache_path(host_addr, cache));
 	}
 
-	exposeOSCQueryMirror { |host_addr, callback|
-		this.forkExpose('oscqm', [host_addr], callback);
+	exposeMinuit { |remote_ip, remote_port, local_port, callback, include, exclude|
+		this.forkExpose('minuit', [remote_ip, remote_port, local_port], callback, include, exclude);
 	}
 
-	exposeMinuit { |remote_ip, remote_port, local_port, callback|
-		this.forkExpose('minuit', [remote_ip, remote_port, local_port], callback);
+	exposeOSC { |remote_ip, remote_port, local_port, callback, batched = false, include, exclude|
+		this.forkExpose('osc', [remote_ip, remote_port, local_port, batched], callback, include, exclude);
 	}
 
-	exposeOSC { |remote_ip, remote_port, local_port, callback|
-		this.forkExpose('osc', [remote_ip, remote_port, local_port], callback);
+	exposeLocal { |local_path, remote_path, callback, include, exclude|
+		this.forkExpose('local', [local_path, remote_path], callback, include, exclude);
 	}
 
 	get { |addr|
 		^OSSIA_MirrorParameter(this, addr)
 	}
 
+	//-------------------------------------------//
+	//               TRANSACTIONS                //
+	//-------------------------------------------//
+
+	beginEdit {
+		_OSSIA_DeviceBeginEdit
+		^this.primitiveFailed
+	}
+
+	commit {
+		_OSSIA_DeviceCommit
+		^this.primitiveFailed
+	}
+
+	edit { |function|
+		this.beginEdit;
+		protect { function.value(this) } { this.commit };
+	}
+
+	// re-created nodes and parameters are updated in place
+	upsert {
+		_OSSIA_DeviceGetUpsert
+		^this.primitiveFailed
+	}
+
+	upsert_ { |aBool|
+		_OSSIA_DeviceSetUpsert
+		^this.primitiveFailed
+	}
+
+	// which parameters are subscribed to on the remote: \selective, \all or \none
+	listen {
+		_OSSIA_DeviceGetListen
+		^this.primitiveFailed
+	}
+
+	listen_ { |aSymbol|
+		_OSSIA_DeviceSetListen
+		^this.primitiveFailed
+	}
+
+	// per-protocol counters, one Event per exposed protocol
+	stats { ^this.pyrStats.collect({|fields| ().putPairs(fields.flatten(1)) }) }
+
+	// publishes the counters under /_stats every interval seconds, nil stops publishing
+	publishStats_ { |interval|
+		m_stats_routine.stop;
+		m_stats_routine = interval !? {
+			fork { loop { this.pyrPublishStats; interval.wait } }
+		};
+	}
+
+	pyrStats {
+		_OSSIA_DeviceStats
+		^this.primitiveFailed
+	}
+
+	pyrPublishStats {
+		_OSSIA_DevicePublishStats
+		^this.primitiveFailed
+	}
+
 	//-------------------------------------------//
 	//             PRIMITIVE CALLS               //
 	//-------------------------------------------//
@@ -409,7 +635,27 @@ OSSIA_Device : OSSIA_Node {
 		^this.primitiveFailed
 	}
 
-	pyrOSCQM { |host_addr|
+	// interpreter callbacks from the mirror loading thread
+	*pvOnMirrorProgress { |id, loaded, total|
+		g_mirror_loads[id] !? { |functions| functions[1].value(loaded, total) };
+	}
+
+	*pvOnMirrorDone { |id, success|
+		g_mirror_loads.removeAt(id) !? { |functions| functions[0].value(success) };
+	}
+
+	*cache_dir { ^Platform.userAppSupportDir +/+ "ossia" +/+ "mirrors" }
+
+	*cache_path { |host_addr, cache|
+		if(cache == true) {
+			File.mkdir(this.cache_dir);
+			^this.cache_dir +/+ host_addr.asString.collect({|c| if(c.isAlphaNum) { c } { $_ } }) ++ ".osnc"
+		};
+		if(cache.isString) { ^cache };
+		^nil
+	}
+
+	pyrOSCQM { |host_addr, id, lazy, cache_path|
 		_OSSIA_ExposeOSCQueryMirror
 		^this.primitiveFailed;
 	}
@@ -419,24 +665,57 @@ OSSIA_Device : OSSIA_Node {
 		^this.primitiveFailed;
 	}
 
-	pyrOSC { |remote_ip, remote_port, local_port|
+	pyrOSC { |remote_ip, remote_port, local_port, batched|
 		_OSSIA_ExposeOSC
 		^this.primitiveFailed
 	}
 
-	pyrDeviceCtor { |name|
+	pyrLocal { |local_path, remote_path|
+		_OSSIA_ExposeLocal
+		^this.primitiveFailed
+	}
+
+	pyrExposeFilter { |include, exclude|
+		_OSSIA_DeviceSetExposeFilter
+		^this.primitiveFailed
+	}
+
+	pyrDeviceCtor { |name, pooled|
 		_OSSIA_InstantiateDevice
 		^this.primitiveFailed
 	}
 
-	pyrFree {
+	pyrFree { |async, id|
 		_OSSIA_FreeDevice
 		^this.primitiveFailed
 	}
 
-	free {
+	// with async = true, the device is detached right away and its protocols
+	// are closed on a background thread, callback is called once it is done
+	free { |async = false, callback|
+		var id;
 		g_devices.remove(this);
-		this.pyrFree();
+		m_stats_routine.stop;
+
+		// mirror loads still running stop with the device, and report it
+		g_mirror_loads.select({ |functions| functions[2] === this }).keysValuesDo({ |id, functions|
+			g_mirror_loads.removeAt(id);
+			functions[0].value(false);
+		});
+
+		if(async && callback.notNil) {
+			g_teardown_count = g_teardown_count + 1;
+			id = g_teardown_count;
+			g_teardowns[id] = callback;
+		};
+
+		this.pyrFree(async, id);
+		if(async.not) { callback.value };
+	}
+
+	// interpreter callback from the teardown thread
+	*pvOnFreed { |id|
+		g_teardowns.removeAt(id).value;
 	}
 
 	*tests {
@@ -448,7 +727,9 @@ OSSIA_Device : OSSIA_Node {
 
 OSSIA_Parameter : OSSIA_Node {
 
-	var m_callback, m_has_callback;
+	// the native side refers to this object weakly: once it is collected,
+	// its finalizer unregisters the callbacks below (slot order is read natively)
+	var m_callback, m_callback_id, m_binding_id, m_finalizer;
 
 	*new {|parent_node, name, type, domain, default_value,
 		bounding_mode = 'free', critical = false,
@@ -460,16 +741,20 @@ OSSIA_Parameter : OSSIA_Node {
 
 	*array { |size, parent_node, name, type, domain, default_value,
 		bounding_mode = 'free', critical = false , repetition_filter = false|
-		^Array.fill(size, {|i|
-			OSSIA_Parameter(parent_node, format(name,i), type, domain, default_value, bounding_mode,
-				critical, repetition_filter);
-		});
+		var handles = this.pyrArrayCtor(size, parent_node, name, type, domain, default_value,
+			bounding_mode, critical, repetition_filter);
+
+		^handles.collect({|handle| super.newFromChild.handleInit(handle) });
 	}
 
-	parameterCtor { |parent, name, type, domain, default_value,
+	*pyrArrayCtor { |size, parent_node, name, type, domain, default_value,
 		bounding_mode, critical, repetition_filter|
+		_OSSIA_InstantiateParameterArray
+		^this.primitiveFailed
+	}
 
-		m_has_callback = false;
+	parameterCtor { |parent, name, type, domain, default_value,
+		bounding_mode, critical, repetition_filter|
 
 		this.pyrCtor(parent, name, type, domain, default_value,
 			bounding_mode, critical, repetition_filter);
@@ -491,11 +776,8 @@ OSSIA_Parameter : OSSIA_Node {
 	}
 
 	value_ { |value|
-		if(m_has_callback)
-		{
-			m_callback.value(value);
-		};
-
+		m_callback.value(value);
+		m_binding_id !? { this.prSendBinding(value) };
 		this.pyrSetValue(value);
 	}
 
@@ -580,37 +862,32 @@ OSSIA_Parameter : OSSIA_Node {
 
 	callback { ^m_callback }
 	callback_ { |callback_function|
-		if(not(m_has_callback))
-		{
-			this.prEnableCallback();
-			m_has_callback = true;
-		}
-		{
-			if(callback_function.isNil())
-			{
-				this.prDisableCallback;
-				m_has_callback = false;
-			}
-		};
-
+		m_callback_id = this.prRemoveCallback(m_callback_id);
 		m_callback = callback_function;
+		callback_function !? { m_callback_id = this.pyrAddCallback() };
+	}
+
+	// returns nil, so that it can reset the id
+	prRemoveCallback { |id|
+		id !? { this.pyrRemoveCallback(id) };
+		^nil
 	}
 
-	prEnableCallback
-	{
-		_OSSIA_ParameterSetCallback
+	pyrAddCallback {
+		_OSSIA_ParameterAddCallback
 		^this.primitiveFailed
 	}
 
-	prDisableCallback
-	{
+	pyrRemoveCallback { |id|
 		_OSSIA_ParameterRemoveCallback
 		^this.primitiveFailed
 	}
 
-	// interpreter callback from attached ossia lambda
-	pvOnCallback { |v|
-		m_callback.value(v);
+	// interpreter callback from attached ossia lambdas
+	pvOnCallback { |id, v|
+		case
+		{ id == m_callback_id } { m_callback.value(v) }
+		{ id == m_binding_id } { this.prSendBinding(v) };
 	}
 
 	//-------------------------------------------//
@@ -623,40 +900,44 @@ OSSIA_Parameter : OSSIA_Node {
 
 	// CONVENIENCE DEF MTHODS
 
-	sym { ^(this.name ++ "_" ++ m_ptr_data.asSymbol).asSymbol }
+	sym {
+		_OSSIA_ParameterGetSymbol
+		^this.primitiveFailed
+	}
 	aar { ^[this.sym, this.value()] }
 
 	kr { | bind = true |
 
-		if(bind) {
-			if(not(m_has_callback)) { this.prEnableCallback; m_has_callback = true };
-			m_callback = { |v| OSSIA.server.sendMsg("/n_set", 0, this.sym, v) };
-		}
-
+		if(bind) { this.prBind }
 		^this.sym.kr
 	}
 
 	ar { | bind = true |
 
-		if(bind) {
-			if(not(m_has_callback)) { this.prEnableCallback; m_has_callback = true };
-			m_callback = { |v| OSSIA.server.sendMsg("/n_set", 0, this.sym, v) };
-		}
-
+		if(bind) { this.prBind }
 		^this.sym.ar
 	}
 
 	tr { ^this.sym.tr}
 
+	// server binding, kept apart from the user callback
+	prBind {
+		m_binding_id ?? {
+			m_binding_id = this.pyrAddCallback();
+		}
+	}
+
+	prSendBinding { |v| OSSIA.server.sendMsg("/n_set", 0, this.sym, v) }
+
+	unbind { m_binding_id = this.prRemoveCallback(m_binding_id) }
+
 }
 
 OSSIA_MirrorParameter : OSSIA_Parameter {
 	*new { |device, address|
-		^super.newFromChild.mirrorInit.pyrGetMirror(device, address);
+		^super.newFromChild.pyrGetMirror(device, address);
 	}
 
-	mirrorInit { m_has_callback = false }
-
 	pyrGetMirror { |device, addr|
 		_OSSIA_NodeGetMirror
 		^this.primitiveFailed
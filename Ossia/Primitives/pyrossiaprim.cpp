@@ -11,13 +11,41 @@
 #include <ossia/network/domain/domain_functions.hpp>
 #include <ossia/network/oscquery/oscquery_server.hpp>
 #include <ossia/network/oscquery/oscquery_mirror.hpp>
-#include <ossia/network/zeroconf/zeroconf.hpp>
+#include <ossia/network/oscquery/detail/json_writer.hpp>
+#include <ossia/network/oscquery/detail/json_parser.hpp>
 #include <ossia-sc/pyrossiaprim.h>
 #include <ossia/preset/preset.hpp>
 #include <ossia/preset/exception.hpp>
 #include <spdlog/spdlog.h>
+#include <spdlog/sinks/base_sink.h>
+#include <spdlog/details/null_mutex.h>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <oscpack/osc/OscOutboundPacketStream.h>
+#include <oscpack/osc/OscReceivedElements.h>
 
 #include <sstream>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+#include <cstdlib>
+#include <cerrno>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <chrono>
+#include <new>
+
+#ifdef OSSIA_SC_DATAGRAM_SOCKETS
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
 
 extern bool compiledOK;
 
@@ -34,13 +62,74 @@ ex_arg_type     ARG_WRONG_TYPE;
 bmap<ossia::val_type>       g_typemap;
 bmap<ossia::bounding_mode>  g_bmodemap;
 bmap<ossia::access_mode>    g_accessmap;
+bmap<explore_column>        g_columnmap;
+bmap<listen_mode>           g_listenmap;
+
+handle_table g_handles;
+callback_registry g_callbacks;
+std::unordered_map<const net::node_base*, PyrSymbol*> g_symcache;
+std::unordered_map<const net::device_base*, std::unique_ptr<device_binding>> g_bindings;
+std::unordered_map<int, std::unique_ptr<explore_cursor>> g_cursors;
+int g_cursor_count = 0;
+std::unordered_map<int, std::unique_ptr<subtree_template>> g_templates;
+int g_template_count = 0;
+std::atomic<bool> g_exiting { false };
+teardown_queue g_teardowns;
+zeroconf_browser g_zeroconf;
+background_jobs g_jobs;
 
 #define SCCBACK_NAME "pvOnCallback"
+
+// how long exit waits for background threads before detaching them
+constexpr auto SHUTDOWN_TIMEOUT = std::chrono::seconds(1);
 #define HDR "OSSIA: "
 #define WRN_HDR "Warning! "
 #define ERR_HDR "Error! "
 #define ADRMAXLEN 128
 
+#ifdef OSSIA_ALLOC_DEBUG
+// allocations are tracked per primitive while enabled from sc (see OSSIA.allocDebug_)
+// operator new is replaced for the whole sclang process, hence the build option
+bool g_alloc_debug = false;
+thread_local alloc_record* t_alloc_record = nullptr;
+std::unordered_map<PrimitiveHandler, alloc_record> g_alloc_records;
+std::unordered_map<PrimitiveHandler, std::string> g_primitive_names;
+
+void* operator new(std::size_t size)
+{
+    if (t_alloc_record)
+    {
+        t_alloc_record->allocations++;
+        t_alloc_record->bytes += size;
+    }
+
+    if (auto ptr = std::malloc(size ? size : 1)) return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+ossia::sc::alloc_scope::alloc_scope(alloc_record& record) noexcept :
+    m_previous(t_alloc_record)
+{
+    record.calls++;
+    t_alloc_record = &record;
+}
+
+ossia::sc::alloc_scope::~alloc_scope()
+{
+    t_alloc_record = m_previous;
+}
+#endif
+
 void ERROTP(const std::exception& e, const char* err_type, const char* descr)
 {
     std::cout << HDR << err_type << e.what() << descr << std::endl;
@@ -100,693 +189,3782 @@ int ossia::sc::check_argument_reference
     return      -1;
 }
 
-inline void ossia::sc::register_sc_node(pyrslot *s, net::node_base *node) noexcept
+int ossia::sc::handle_table::insert(net::node_base& node, net::generic_device* device,
+                                   net::multiplex_protocol* multiplex)
 {
-    pyrslot *ptr_var = slotRawObject(s)->slots;
-    SetPtr  (ptr_var, node);
+    auto it = m_handles.find(&node);
+    if  (it != m_handles.end()) return it->second;
+
+    uint32_t index;
+    if (m_free.empty())
+    {
+        if (m_entries.size() >= MAX_ENTRIES) throw std::runtime_error("too many node handles");
+        index = m_entries.size();
+        m_entries.push_back({ nullptr, nullptr, nullptr, 1 });
+    }
+    else
+    {
+        index = m_free.front();
+        m_free.pop_front();
+    }
+
+    auto& entry         = m_entries[index];
+    entry.node          = &node;
+    entry.device        = device;
+    entry.multiplex     = multiplex;
+
+    int handle          = static_cast<int>((index << GENERATION_BITS) | entry.generation);
+    m_handles[&node]    = handle;
+    return              handle;
 }
 
-inline ossia::net::node_base* ossia::sc::get_node(pyrslot *s)
+const ossia::sc::handle_table::entry* ossia::sc::handle_table::get(int handle) const noexcept
 {
-    try { check_argument_type(s, { "OSSIA_Parameter", "OSSIA_Node",
-                                   "OSSIA_MirrorParameter", "OSSIA_MirrorNode",
-                                   "OSSIA_Device" }); }
+    auto index = static_cast<uint32_t>(handle) >> GENERATION_BITS;
+    if  (index >= m_entries.size()) return nullptr;
+
+    auto& entry = m_entries[index];
+    if  (!entry.node || entry.generation != (static_cast<uint32_t>(handle) & GENERATION_MASK))
+         return nullptr;
 
-    catch( const std::exception &e ) { throw; }
-    return (net::node_base*) slotRawPtr(&slotRawObject(s)->slots[0]);
+    return &entry;
 }
 
-template<class T>
-T ossia::sc::read_listed_attribute
-(pyrslot *s, boost::bimap<std::string, boost::bimaps::multiset_of<T>> target_map)
+ossia::net::node_base* ossia::sc::handle_table::find(int handle) const noexcept
 {
-    try                             { check_argument_definition(s); }
-    catch(const std::exception &e)  { throw; }
-
-    auto attr        = sc::read_string(s);
-    int  ref_check   = check_argument_reference<T>(attr, target_map);
+    auto entry = get(handle);
+    return entry ? entry->node : nullptr;
+}
 
-    if ( ref_check >=0 )    return static_cast<T>(ref_check);
-    else                    throw  ARG_BAD_VALUE;
+ossia::net::generic_device* ossia::sc::handle_table::find_device(int handle) const noexcept
+{
+    auto entry = get(handle);
+    return entry ? entry->device : nullptr;
 }
 
-std::string ossia::sc::read_classname(pyrslot* s) noexcept
+ossia::net::multiplex_protocol* ossia::sc::handle_table::find_multiplex(int handle) const noexcept
 {
-    PyrClass     *classobj       =   classOfSlot(s);
-    std::string  metaclassname   =   slotRawSymbol(&classobj->name)->name;
+    auto entry = get(handle);
+    return entry ? entry->multiplex : nullptr;
+}
 
-    if(metaclassname.find("Meta_") == std::string::npos) return metaclassname;
-    else return metaclassname.erase(0, 5);
+void ossia::sc::handle_table::erase(const net::node_base& node) noexcept
+{
+    auto it = m_handles.find(&node);
+    if  (it == m_handles.end()) return;
+
+    auto index  = static_cast<uint32_t>(it->second) >> GENERATION_BITS;
+    auto& entry = m_entries[index];
+
+    // generation 0 is never handed out, so that a nil slot can't match,
+    // and a slot whose generation would wrap is retired instead of reused
+    auto generation = entry.generation;
+    entry       = { nullptr, nullptr, nullptr, generation + 1 };
+    if  (generation < GENERATION_MASK) m_free.push_back(index);
+    m_handles.erase(it);
 }
 
-std::string ossia::sc::read_string(pyrslot *s)
-{    
-    try
+int ossia::sc::callback_registry::add(net::parameter_base& parameter, pyrobject* owner)
+{
+    uint32_t index;
+    if (m_free.empty())
     {
-        auto type = check_argument_type(s, { "String", "Symbol" });
+        if (m_entries.size() >= MAX_ENTRIES) throw std::runtime_error("too many callbacks");
+        index = m_entries.size();
+        m_entries.push_back({ nullptr, nullptr, {}, 1, NONE, NONE });
+    }
+    else
+    {
+        index = m_free.front();
+        m_free.pop_front();
+    }
 
-        if          (type == "Symbol")
-        return      (std::string) slotSymString(s);
-        else
+    auto& entry = m_entries[index];
+    int id      = static_cast<int>((index << GENERATION_BITS) | entry.generation);
+
+    // the owner is resolved under the lang mutex, once its finalizer
+    // has run the id no longer resolves and the value is dropped
+    auto g = gMainVMGlobals;
+    entry.callback = parameter.add_callback([this, g, id](const ossia::value& v)
+    {
+        gLangMutex.lock();
+
+        auto object = owner(id);
+        if (compiledOK && object)
         {
-            char v      [ADRMAXLEN];
-            slotStrVal  (s, v, ADRMAXLEN);
-            return      (std::string) v;
+            g->canCallOS        = true;
+            ++g->sp;            SetObject(g->sp, object);
+            ++g->sp;            SetInt(g->sp, id);
+            ++g->sp;            ossia::sc::write_value(g, g->sp, v);
+            runInterpreter      (g, getsym(SCCBACK_NAME), 3);
+            g->canCallOS        = false;
         }
 
+        gLangMutex.unlock();
+    });
+
+    // linked per parameter, so that removing a parameter drops its entries
+    entry.parameter = &parameter;
+    entry.owner     = owner;
+    entry.previous  = NONE;
+    entry.next      = NONE;
+
+    auto head = m_heads.find(&parameter);
+    if  (head != m_heads.end())
+    {
+        entry.next = head->second;
+        m_entries[head->second].previous = index;
+        head->second = index;
     }
+    else m_heads.emplace(&parameter, index);
 
-    catch (const std::exception& e) { throw; }
+    return id;
+}
+
+const ossia::sc::callback_registry::entry*
+ossia::sc::callback_registry::find(int id) const noexcept
+{
+    auto index = static_cast<uint32_t>(id) >> GENERATION_BITS;
+    if  (index >= m_entries.size()) return nullptr;
+
+    auto& entry = m_entries[index];
+    if  (!entry.parameter || entry.generation != (static_cast<uint32_t>(id) & GENERATION_MASK))
+         return nullptr;
 
+    return &entry;
 }
 
-char ossia::sc::read_char(pyrslot *s)
+pyrobject* ossia::sc::callback_registry::owner(int id) const noexcept
 {
-    try
-    {
-        auto type = check_argument_type(s, { "Char", "Symbol" });
+    auto entry = find(id);
+    return entry ? entry->owner : nullptr;
+}
 
-        if          (type == "Symbol")
-        return      *slotSymString(s);
-        else return  s->u.c;
-    }
-    catch   ( const std::exception& e) { throw; }
+net::parameter_base* ossia::sc::callback_registry::parameter(int id) const noexcept
+{
+    auto entry = find(id);
+    return entry ? entry->parameter : nullptr;
 }
 
-float ossia::sc::read_float(pyrslot *s)
+bool ossia::sc::callback_registry::remove(int id) noexcept
 {
-    try
-    {
-        auto type = check_argument_type(s, { "Float", "Integer" });
-        if(type == "Float")
-        {
-            float           f;
-            slotFloatVal    (s, &f);
-            return          f;
-        }
+    if  (!find(id)) return false;
 
-        return (float) sc::read_int(s);
+    auto index  = static_cast<uint32_t>(id) >> GENERATION_BITS;
+    auto& entry = m_entries[index];
 
-    }
+    entry.parameter->remove_callback(entry.callback);
 
-    catch(const std::exception& e) { throw; }
-}
+    if  (entry.previous != NONE) m_entries[entry.previous].next = entry.next;
+    else if (entry.next != NONE) m_heads[entry.parameter] = entry.next;
+    else m_heads.erase(entry.parameter);
 
-int ossia::sc::read_int(pyrslot *s)
-{
-    try     { check_argument_type(s, { "Integer" }); }
-    catch   ( const std::exception& e) { throw; }
+    if  (entry.next != NONE) m_entries[entry.next].previous = entry.previous;
 
-    int             i;
-    slotIntVal      (s, &i);
-    return          i;
+    release(index);
+    return true;
 }
 
-ossia::val_type ossia::sc::read_type(pyrslot *s)
+bool ossia::sc::callback_registry::forget(const net::parameter_base& parameter) noexcept
 {
-    try                             { check_argument_definition(s); }
-    catch(const std::exception &e)  { throw; }
+    // the parameter is going away along with its callbacks, only the ids are invalidated
+    auto head = m_heads.find(&parameter);
+    if  (head == m_heads.end()) return false;
 
-    auto mcn         = read_classname(s);
-    int  ref_check   = check_argument_reference<ossia::val_type>(mcn, g_typemap);
+    for (auto index = head->second; index != NONE; )
+    {
+        auto next = m_entries[index].next;
+        release(index);
+        index = next;
+    }
 
-    if ( ref_check >=0 ) return static_cast<ossia::val_type>(ref_check);
-    else                 throw  ARG_WRONG_TYPE;
+    m_heads.erase(head);
+    return true;
 }
 
-ossia::domain ossia::sc::read_domain(pyrslot *s, ossia::val_type t)
+void ossia::sc::callback_registry::release(uint32_t index) noexcept
 {
-    pyrslot*        target;
-    std::string     classname;
-    ossia::domain   domain;
+    // a slot whose generation would wrap is retired rather than handing out an id seen before
+    auto& entry = m_entries[index];
+    auto  generation = entry.generation;
+    entry       = { nullptr, nullptr, {}, generation + 1, NONE, NONE };
 
-    try     { classname = check_argument_type(s, { "Array", "List", "OSSIA_domain"}); }
-    catch   (const std::exception& e) { throw; }
+    if  (generation < GENERATION_MASK) m_free.push_back(index);
+    else m_retired++;
+}
 
-    if  (classname == "List" || classname ==  "Array")
-    {
-        target      = s;
-    }
-    else if (classname == "OSSIA_domain")
-    {
-        target      = slotRawObject(s)->slots;
-    }
+inline void ossia::sc::register_sc_node(pyrslot *s, net::node_base *node)
+{
+    SetInt  (slotRawObject(s)->slots, g_handles.insert(*node));
+}
 
-    auto pre_domain = sc::read_vector<ossia::value>(target, sc::read_value);
+int read_handle(pyrslot *s)
+{
+    // a class pointer test rather than a classname string comparison
+    if (!isKindOfSlot(s, getsym("OSSIA_Node")->u.classobj)) throw ARG_WRONG_TYPE;
 
-    if      (pre_domain.size() == 2)
-            domain = ossia::make_domain(pre_domain[0], pre_domain[1]);
+    auto handle_slot = slotRawObject(s)->slots;
+    if  (!IsInt(handle_slot)) throw NODE_NOT_FOUND;
 
-    else if (pre_domain.size() == 3)
-            domain = ossia::make_domain(pre_domain[0], pre_domain[1],
-                     pre_domain[2].get<std::vector<ossia::value>>());
+    return slotRawInt(handle_slot);
+}
 
-    else throw ARG_BAD_VALUE;
+inline ossia::net::node_base* ossia::sc::get_node(pyrslot *s)
+{
+    try     { check_argument_definition(s); }
+    catch   ( const std::exception &e ) { throw; }
 
-    return domain;
+    auto node = g_handles.find(read_handle(s));
+    if  (!node) throw NODE_NOT_FOUND;
+    return node;
 }
 
-template<class T>
-std::vector<T> ossia::sc::read_vector(pyrslot *s, T (*getter_function)(pyrslot*))
+ossia::net::parameter_base* ossia::sc::get_parameter(pyrslot *s)
 {
-    auto obj = slotRawObject(s);
-    std::vector<T> vector;
+    // the node may have lost its parameter, e.g. when re-created as a plain OSSIA_Node
+    auto parameter = get_node(s)->get_parameter();
+    if  (!parameter) throw NODE_NOT_FOUND;
+    return parameter;
+}
 
-    for     (int i = 0; i < obj->size; ++i)
-            vector.push_back(getter_function(obj->slots+i));
+ossia::net::generic_device& ossia::sc::get_device(pyrslot *s)
+{
+    try     { check_argument_definition(s); }
+    catch   ( const std::exception &e ) { throw; }
 
-    return  vector;
+    auto device = g_handles.find_device(read_handle(s));
+    if  (!device) throw NODE_NOT_FOUND;
+    return *device;
 }
 
-template<class T, class U>
-T ossia::sc::read_array(pyrslot *s, U (*getter_function)(pyrslot*))
+ossia::net::multiplex_protocol& ossia::sc::get_multiplex(pyrslot *s)
 {
-    T array;
-    pyrobject* target;
-    auto classname = sc::read_classname(s);
+    try     { check_argument_definition(s); }
+    catch   ( const std::exception &e ) { throw; }
 
-    if(     classname == "Array" || classname == "List")
-            target = slotRawObject(s);
-    else    target = slotRawObject(slotRawObject(s)->slots);
+    auto multiplex = g_handles.find_multiplex(read_handle(s));
+    if  (!multiplex) throw NODE_NOT_FOUND;
+    return *multiplex;
+}
 
-    if      (array.size() != target->size) throw ARG_BAD_VALUE;
+PyrSymbol* ossia::sc::parameter_symbol(net::node_base& node)
+{
+    auto it = g_symcache.find(&node);
+    if  (it != g_symcache.end()) return it->second;
 
-    for     (int i = 0; i < target->size; ++i)
-            array[i] = getter_function(target->slots+i);
+    std::stringstream sym_stream;
+    sym_stream << node.get_name() << "_" << &node;
 
-    return  array;
+    auto sym            = getsym(sym_stream.str().c_str());
+    g_symcache[&node]   = sym;
+    return              sym;
 }
 
-ossia::value ossia::sc::read_value(pyrslot *s)
+ossia::sc::path_index::path_index(net::device_base& device) :
+    m_device(device)
 {
-    auto vtype = sc::read_type(s);
-    switch( vtype )
-    {
-    case val_type::INT:  return ossia::value(read_float(s)); break; // allows int to float conversion in sc...
-    case val_type::BOOL: return ossia::value(IsTrue(s)); break;
-    case val_type::CHAR: return ossia::value(read_char(s)); break;
-    case val_type::FLOAT: return ossia::value(read_float(s)); break;
-    case val_type::LIST: return ossia::value(read_vector<ossia::value>(s, read_value)); break;
-    case val_type::VEC2F: return ossia::value(read_array<vec2f, float>(s, sc::read_float)); break;
-    case val_type::VEC3F: return ossia::value(read_array<vec3f, float>(s, sc::read_float)); break;
-    case val_type::VEC4F: return ossia::value(read_array<vec4f, float>(s, sc::read_float)); break;
-    case val_type::STRING:  return ossia::value(read_string(s)); break;
-    case val_type::IMPULSE: return ossia::impulse{}; break;
-    default: throw  ARG_WRONG_TYPE;
-    }
+    insert_subtree(device.get_root_node());
 
-    return ossia::value();
+    m_device.on_node_created.connect<&path_index::on_node_created>(this);
+    m_device.on_node_removing.connect<&path_index::on_node_removing>(this);
+    m_device.on_node_renamed.connect<&path_index::on_node_renamed>(this);
 }
 
-template<class T>
-std::string ossia::sc::format_listed_attribute
-(T attribute, boost::bimap<std::string, boost::bimaps::multiset_of<T>> target_map) noexcept
+ossia::sc::path_index::~path_index()
 {
-    typedef  boost::bimap<std::string, boost::bimaps::multiset_of<T>> bm_type;
-    typename bm_type::right_const_iterator r_iter = target_map.right.find(attribute);
+    m_device.on_node_created.disconnect<&path_index::on_node_created>(this);
+    m_device.on_node_removing.disconnect<&path_index::on_node_removing>(this);
+    m_device.on_node_renamed.disconnect<&path_index::on_node_renamed>(this);
+}
 
-    if      (r_iter == target_map.right.end())
-            return "nil";
-    else    return (r_iter->second);
+net::node_base* ossia::sc::path_index::find(const std::string& path) const noexcept
+{
+    auto it = m_nodes.find(path);
+    if  (it == m_nodes.end()) return nullptr;
+    return it->second;
 }
 
-template<class T, class F>
-void ossia::sc::write_array(vmglobals *g, pyrslot *target,
-const T& values, void (*writer_func)(vmglobals*, pyrslot*, const F&)) noexcept
+void ossia::sc::path_index::insert(net::node_base& node)
 {
-    int sz = values.size();
-    auto array = newPyrArray(g->gc, sz, 0, true);
-    SetObject(target, array);
+    m_nodes[net::osc_parameter_string(node)] = &node;
+}
 
-    for(int i = 0; i < sz; i++)
-    {
-        writer_func(g, array->slots+i, values[i]);
-        array->size++;
-    }
+void ossia::sc::path_index::on_node_created(net::node_base& node)
+{
+    insert_subtree(node);
 }
 
-inline void ossia::sc::write_string(vmglobals *g, pyrslot *target, const std::string& string) noexcept
+void ossia::sc::path_index::on_node_removing(const net::node_base& node)
 {
-    PyrString*  str = newPyrString(g->gc, string.c_str(), 0, true);
-    SetObject   (target, str);
+    erase_subtree(node);
 }
 
-void ossia::sc::write_value(vmglobals *g, pyrslot *target, const ossia::value& value) noexcept
+void ossia::sc::path_index::on_node_renamed(net::node_base& node, std::string old_name)
 {
-    ossia::val_type vtype;
-    if(value.valid()) vtype = value.get_type();
-    else vtype = ossia::val_type::NONE;
+    // every path under the renamed node changes: re-key its whole subtree
+    auto new_prefix = net::osc_parameter_string(node);
+    auto old_prefix = new_prefix.substr(0, new_prefix.size() - node.get_name().size()) + old_name;
 
-    switch ( vtype )
+    for (auto it = m_nodes.begin(); it != m_nodes.end(); )
     {
-    case ossia::val_type::IMPULSE:  SetNil(target); break;
-    case ossia::val_type::NONE:     SetNil(target); break;
-    case ossia::val_type::BOOL:     SetBool(target, value.get<bool>()); break;
-    case ossia::val_type::CHAR:     SetChar(target, value.get<char>()); break;
-    case ossia::val_type::FLOAT:    SetFloat(target, value.get<float>()); break;
-    case ossia::val_type::INT:      SetInt(target, value.get<int>()); break;
-    case ossia::val_type::STRING:   sc::write_string(g, target, value.get<std::string>()); break;
-    case ossia::val_type::LIST:     sc::write_array<std::vector<ossia::value>,ossia::value>(g, target, value.get<std::vector<ossia::value>>(), sc::write_value); break;
-    case ossia::val_type::VEC2F:    sc::write_array<vec2f,ossia::value>(g, target, value.get<vec2f>(), sc::write_value); break;
-    case ossia::val_type::VEC3F:    sc::write_array<vec3f,ossia::value>(g, target, value.get<vec3f>(), sc::write_value); break;
-    case ossia::val_type::VEC4F:    sc::write_array<vec4f,ossia::value>(g, target, value.get<vec4f>(), sc::write_value); break;
+        const auto& key = it->first;
+        if (key.compare(0, old_prefix.size(), old_prefix) == 0 &&
+           (key.size() == old_prefix.size() || key[old_prefix.size()] == '/'))
+             it = m_nodes.erase(it);
+        else ++it;
     }
+
+    insert_subtree(node);
 }
 
-int pyr_zeroconf_explore(vmglobals *g, int n)
-{  
-    auto list = ossia::net::list_oscquery_devices();
-    std::vector<ossia::value> res;
+void ossia::sc::path_index::insert_subtree(net::node_base& node)
+{
+    insert(node);
+    for (const auto& child : node.children_copy())
+        insert_subtree(*child);
+}
 
-    for(auto& device : list)
-    {
-        std::vector<ossia::value> devaslist;
-        devaslist.push_back((ossia::value) device.name);
-        devaslist.push_back((ossia::value) device.host);
-        devaslist.push_back((ossia::value) device.port);
-        res.push_back(devaslist);
-    }
+void ossia::sc::path_index::erase_subtree(const net::node_base& node)
+{
+    m_nodes.erase(net::osc_parameter_string(node));
+    for (const auto& child : node.children_copy())
+        erase_subtree(*child);
+}
 
-    sc::write_value(g, g->sp, res);
+ossia::sc::block_pool::block_pool(std::size_t block_size, std::size_t blocks_per_chunk) :
+    m_block_size(HEADER_SIZE + (block_size + HEADER_SIZE - 1) / HEADER_SIZE * HEADER_SIZE),
+    m_blocks_per_chunk(blocks_per_chunk)
+{
 
-    return errNone;
 }
 
-int pyr_instantiate_device(vmglobals *g, int n)
+void* ossia::sc::block_pool::allocate()
 {
-    try      { ossia::sc::check_argument_type(g->sp, { "String", "Symbol" }); }
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_free.empty())
+    {
+        m_chunks.emplace_back(new char[m_block_size * m_blocks_per_chunk]);
+        auto chunk = m_chunks.back().get();
+
+        m_free.reserve(m_free.size() + m_blocks_per_chunk);
+        for (std::size_t i = m_blocks_per_chunk; i > 0; --i)
+            m_free.push_back(chunk + (i - 1) * m_block_size);
+    }
+
+    auto block = m_free.back();
+    m_free.pop_back();
+    m_used++;
+
+    reinterpret_cast<header*>(block)->pool = this;
+    return block + HEADER_SIZE;
+}
+
+void ossia::sc::block_pool::deallocate(void* object) noexcept
+{
+    if  (!object) return;
+    auto block = static_cast<char*>(object) - HEADER_SIZE;
+    reinterpret_cast<header*>(block)->pool->release(block);
+}
+
+void ossia::sc::block_pool::release(char* block) noexcept
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_free.push_back(block);
+    m_used--;
+}
+
+std::size_t ossia::sc::block_pool::used() const noexcept
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_used;
+}
+
+std::size_t ossia::sc::block_pool::reserved_bytes() const noexcept
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_chunks.size() * m_block_size * m_blocks_per_chunk;
+}
+
+void* ossia::sc::pooled_parameter::operator new(std::size_t size, block_pool& pool)
+{
+    return pool.allocate();
+}
+
+void ossia::sc::pooled_parameter::operator delete(void* object) noexcept
+{
+    block_pool::deallocate(object);
+}
+
+void ossia::sc::pooled_parameter::operator delete(void* object, block_pool& pool) noexcept
+{
+    block_pool::deallocate(object);
+}
+
+ossia::sc::pooled_node::pooled_node(std::string name, net::device_base& device,
+                                    net::node_base& parent, node_pools& pools) :
+    net::generic_node(std::move(name), device, parent),
+    m_pools(pools)
+{
+
+}
+
+ossia::net::parameter_base* ossia::sc::pooled_node::create_parameter(val_type type)
+{
+    // same steps as generic_node, with the parameter taken from the pool
+    remove_parameter();
+
+    auto parameter = new (m_pools.parameters) pooled_parameter(*this);
+    parameter->set_value_type(type);
+    set_parameter(std::unique_ptr<net::parameter_base>(parameter));
+
+    return parameter;
+}
+
+std::unique_ptr<ossia::net::node_base> ossia::sc::pooled_node::make_child(const std::string& name)
+{
+    return std::unique_ptr<net::node_base>
+           (new (m_pools.nodes) pooled_node(name, get_device(), *this, m_pools));
+}
+
+void* ossia::sc::pooled_node::operator new(std::size_t size, block_pool& pool)
+{
+    return pool.allocate();
+}
+
+void ossia::sc::pooled_node::operator delete(void* object) noexcept
+{
+    block_pool::deallocate(object);
+}
+
+void ossia::sc::pooled_node::operator delete(void* object, block_pool& pool) noexcept
+{
+    block_pool::deallocate(object);
+}
+
+ossia::net::node_base& ossia::sc::create_child(net::node_base& parent, const std::string& name)
+{
+    auto binding = get_binding(parent.get_device());
+    if  (!binding || !binding->pools)
+    {
+        if (name.find('/') != std::string::npos)
+             return net::find_or_create_node(parent, name);
+        else return *parent.create_child(name);
+    }
+
+    // intermediate nodes are pooled too, find_or_create_node would
+    // go through the (non-pooled) root node's make_child
+    auto& pools = *binding->pools;
+    auto  node  = &parent;
+    std::size_t start = 0;
+
+    while (start <= name.size())
+    {
+        auto end = name.find('/', start);
+        if  (end == std::string::npos) end = name.size();
+
+        if  (end > start)
+        {
+            auto segment = net::sanitize_name(name.substr(start, end-start));
+            auto child   = node->find_child(segment);
+
+            if  (!child) child = node->add_child(std::unique_ptr<net::node_base>(
+                 new (pools.nodes) pooled_node(segment, node->get_device(), *node, pools)));
+            node = child;
+        }
+
+        start = end+1;
+    }
+
+    return *node;
+}
+
+std::size_t ossia::sc::value_footprint(const ossia::value& value) noexcept
+{
+    if (!value.valid()) return 0;
+
+    switch (value.get_type())
+    {
+    case ossia::val_type::STRING:
+    {
+        // short strings are stored inline
+        auto& str = value.get<std::string>();
+        return str.capacity() > sizeof(std::string) ? str.capacity() + 1 : 0;
+    }
+    case ossia::val_type::LIST:
+    {
+        auto& list = value.get<std::vector<ossia::value>>();
+        std::size_t bytes = list.capacity() * sizeof(ossia::value);
+        for (const auto& v : list) bytes += value_footprint(v);
+        return bytes;
+    }
+    default: return 0;
+    }
+}
+
+void measure_subtree(net::node_base& node, footprint& fp, std::size_t path_length, bool indexed)
+{
+    // pooled nodes and parameters live in pool_bytes, only their own heap storage counts here
+    fp.nodes++;
+    fp.node_bytes += node.get_name().capacity();
+    if (!dynamic_cast<pooled_node*>(&node)) fp.node_bytes += sizeof(net::generic_node);
+
+    // the device's path index and the handle/symbol caches hold one entry per node
+    if (indexed) fp.binding_bytes += sizeof(std::pair<const std::string, net::node_base*>)
+                                   + 2*sizeof(void*) + path_length + 1;
+
+    auto& attributes = node.get_extended_attributes();
+    for (const auto& attribute : attributes)
+        fp.attribute_bytes += sizeof(attribute) + 2*sizeof(void*) + attribute.first.capacity();
+
+    if (auto parameter = node.get_parameter())
+    {
+        fp.parameters++;
+        fp.callbacks   += parameter->callback_count();
+        if (!dynamic_cast<pooled_parameter*>(parameter)) fp.node_bytes += sizeof(net::generic_parameter);
+        fp.value_bytes += sizeof(ossia::value) + value_footprint(parameter->value());
+    }
+
+    auto children = node.children_copy();
+    fp.node_bytes += children.size() * sizeof(std::unique_ptr<net::node_base>);
+
+    for (const auto& child : children)
+        measure_subtree(*child, fp, path_length + 1 + child->get_name().size(), indexed);
+}
+
+ossia::sc::footprint ossia::sc::measure_footprint(net::node_base& root)
+{
+    footprint fp;
+    auto& device    = root.get_device();
+    auto  binding   = get_binding(device);
+
+    measure_subtree(root, fp, ossia::net::osc_parameter_string(root).size(), binding);
+
+    if (&root == &device.get_root_node())
+    {
+        // protocol buffers are not exposed by libossia, only protocols are counted
+        if (auto multiplex = dynamic_cast<net::multiplex_protocol*>(&device.get_protocol()))
+             fp.protocols = multiplex->get_protocols().size();
+        else fp.protocols = 1;
+
+        if (binding && binding->pools)
+            fp.pool_bytes = binding->pools->nodes.reserved_bytes()
+                          + binding->pools->parameters.reserved_bytes();
+    }
+
+    return fp;
+}
+
+ossia::sc::device_binding* ossia::sc::get_binding(const net::device_base& device) noexcept
+{
+    auto it = g_bindings.find(&device);
+    if  (it == g_bindings.end()) return nullptr;
+    return it->second.get();
+}
+
+void ossia::sc::edit_transaction::commit()
+{
+    // only remove the topmost pending nodes, their subtrees go along
+    std::vector<net::node_base*> tops;
+    for (auto node : removals)
+    {
+        bool nested = false;
+        for (auto parent = node->get_parent(); parent && !nested; parent = parent->get_parent())
+            nested = removals.count(parent);
+
+        if (!nested) tops.push_back(node);
+    }
+
+    removals.clear();
+    for (auto node : tops) node->get_parent()->remove_child(*node);
+
+    auto pending = std::move(pushes);
+    pushes.clear();
+
+    for (auto parameter : pending)
+        parameter->get_node().get_device().get_protocol().push(*parameter);
+}
+
+void ossia::sc::update_listening(net::parameter_base& parameter)
+{
+    auto& device    = parameter.get_node().get_device();
+    auto  binding   = get_binding(device);
+    auto  mode      = binding ? binding->listen : LISTEN_SELECTIVE;
+
+    bool listen = mode == LISTEN_ALL || (mode == LISTEN_SELECTIVE && parameter.callback_count() > 0);
+    device.get_protocol().observe(parameter, listen);
+}
+
+void ossia::sc::push_parameter(net::parameter_base& parameter)
+{
+    auto binding = get_binding(parameter.get_node().get_device());
+
+    if  (binding && binding->edit.active())
+         binding->edit.pushes.insert(&parameter);
+    else parameter.get_node().get_device().get_protocol().push(parameter);
+}
+
+net::node_base* ossia::sc::find_node(net::node_base& origin, const std::string& address)
+{
+    auto binding = get_binding(origin.get_device());
+    if  (!binding)
+         return ossia::net::find_node(origin, address);
+
+    std::string path;
+    if (&origin != &origin.get_device().get_root_node())
+         path = net::osc_parameter_string(origin);
+
+    if (address.empty() || address[0] != '/') path += '/';
+    path += address;
+
+    if (auto node = binding->index.find(path))
+        return node;
+
+    // e.g. a partially indexed mirror: walk the tree once, then remember
+    auto node = ossia::net::find_node(origin, address);
+
+    if (!node && binding->shadow)
+    {
+        // lazy mirror: materialise the path one level at a time
+        node = &origin;
+        std::size_t start = 0;
+
+        while (node && start < address.size())
+        {
+            auto end = address.find('/', start);
+            if  (end == std::string::npos) end = address.size();
+
+            if  (end > start)
+            {
+                expand(*node, 1);
+                node = node->find_child(address.substr(start, end-start));
+            }
+
+            start = end+1;
+        }
+    }
+
+    if  (node) binding->index.insert(*node);
+    return node;
+}
+
+void ossia::sc::forget_parameter(net::parameter_base& parameter) noexcept
+{
+    auto& device = parameter.get_node().get_device();
+
+    // removed parameters that had sc callbacks stop listening on the remote
+    if (g_callbacks.forget(parameter))
+        device.get_protocol().observe(parameter, false);
+
+    if (auto binding = get_binding(device))
+        binding->edit.pushes.erase(&parameter);
+}
+
+void ossia::sc::forget_subtree(net::node_base& node) noexcept
+{
+    g_handles.erase(node);
+    g_symcache.erase(&node);
+
+    if (auto parameter = node.get_parameter())
+        forget_parameter(*parameter);
+
+    if (auto binding = get_binding(node.get_device()))
+    {
+        binding->edit.removals.erase(&node);
+        binding->expanded.erase(&node);
+        for (auto& filter : binding->filters) filter->forget(node);
+    }
+
+    for (const auto& child : node.children_copy())
+        forget_subtree(*child);
+}
+
+void on_node_removing(const net::node_base& node)
+{
+    sc::forget_subtree(const_cast<net::node_base&>(node));
+}
+
+void on_parameter_removing(const net::parameter_base& parameter)
+{
+    // parameters can go while their node stays: re-created as a plain node,
+    // retyped by a pooled node, or dropped by the remote of a mirror
+    sc::forget_parameter(const_cast<net::parameter_base&>(parameter));
+}
+
+void on_node_renamed(net::node_base& node, std::string old_name)
+{
+    // addresses change below the renamed node, filters are evaluated again on next push
+    if (auto binding = sc::get_binding(node.get_device()))
+        for (auto& filter : binding->filters) filter->clear();
+}
+
+template<class T>
+T ossia::sc::read_listed_attribute
+(pyrslot *s, boost::bimap<std::string, boost::bimaps::multiset_of<T>> target_map)
+{
+    try                             { check_argument_definition(s); }
+    catch(const std::exception &e)  { throw; }
+
+    auto attr        = sc::read_string(s);
+    int  ref_check   = check_argument_reference<T>(attr, target_map);
+
+    if ( ref_check >=0 )    return static_cast<T>(ref_check);
+    else                    throw  ARG_BAD_VALUE;
+}
+
+std::string ossia::sc::read_classname(pyrslot* s) noexcept
+{
+    PyrClass     *classobj       =   classOfSlot(s);
+    std::string  metaclassname   =   slotRawSymbol(&classobj->name)->name;
+
+    if(metaclassname.find("Meta_") == std::string::npos) return metaclassname;
+    else return metaclassname.erase(0, 5);
+}
+
+std::string ossia::sc::read_string(pyrslot *s)
+{    
+    try
+    {
+        auto type = check_argument_type(s, { "String", "Symbol" });
+
+        if          (type == "Symbol")
+        return      (std::string) slotSymString(s);
+        else
+        {
+            char v      [ADRMAXLEN];
+            slotStrVal  (s, v, ADRMAXLEN);
+            return      (std::string) v;
+        }
+
+    }
+
+    catch (const std::exception& e) { throw; }
+
+}
+
+char ossia::sc::read_char(pyrslot *s)
+{
+    try
+    {
+        auto type = check_argument_type(s, { "Char", "Symbol" });
+
+        if          (type == "Symbol")
+        return      *slotSymString(s);
+        else return  s->u.c;
+    }
+    catch   ( const std::exception& e) { throw; }
+}
+
+float ossia::sc::read_float(pyrslot *s)
+{
+    try
+    {
+        auto type = check_argument_type(s, { "Float", "Integer" });
+        if(type == "Float")
+        {
+            float           f;
+            slotFloatVal    (s, &f);
+            return          f;
+        }
+
+        return (float) sc::read_int(s);
+
+    }
+
+    catch(const std::exception& e) { throw; }
+}
+
+int ossia::sc::read_int(pyrslot *s)
+{
+    try     { check_argument_type(s, { "Integer" }); }
+    catch   ( const std::exception& e) { throw; }
+
+    int             i;
+    slotIntVal      (s, &i);
+    return          i;
+}
+
+ossia::val_type ossia::sc::read_type(pyrslot *s)
+{
+    try                             { check_argument_definition(s); }
+    catch(const std::exception &e)  { throw; }
+
+    auto mcn         = read_classname(s);
+    int  ref_check   = check_argument_reference<ossia::val_type>(mcn, g_typemap);
+
+    if ( ref_check >=0 ) return static_cast<ossia::val_type>(ref_check);
+    else                 throw  ARG_WRONG_TYPE;
+}
+
+ossia::domain ossia::sc::read_domain(pyrslot *s, ossia::val_type t)
+{
+    pyrslot*        target;
+    std::string     classname;
+    ossia::domain   domain;
+
+    try     { classname = check_argument_type(s, { "Array", "List", "OSSIA_domain"}); }
+    catch   (const std::exception& e) { throw; }
+
+    if  (classname == "List" || classname ==  "Array")
+    {
+        target      = s;
+    }
+    else if (classname == "OSSIA_domain")
+    {
+        target      = slotRawObject(s)->slots;
+    }
+
+    auto pre_domain = sc::read_vector<ossia::value>(target, sc::read_value);
+
+    if      (pre_domain.size() == 2)
+            domain = ossia::make_domain(pre_domain[0], pre_domain[1]);
+
+    else if (pre_domain.size() == 3)
+            domain = ossia::make_domain(pre_domain[0], pre_domain[1],
+                     pre_domain[2].get<std::vector<ossia::value>>());
+
+    else throw ARG_BAD_VALUE;
+
+    return domain;
+}
+
+uint8_t ossia::sc::read_columns(pyrslot *s)
+{
+    // no selection means every column
+    if (IsNil(s)) return COL_ALL;
+
+    try     { check_argument_type(s, { "Array", "List" }); }
+    catch   ( const std::exception& e ) { throw; }
+
+    uint8_t columns = 0;
+    for (const auto& column : sc::read_vector<std::string>(s, sc::read_string))
+    {
+        int ref_check = check_argument_reference<explore_column>(column, g_columnmap);
+        if (ref_check < 0) throw ARG_BAD_VALUE;
+        columns |= static_cast<uint8_t>(ref_check);
+    }
+
+    return columns;
+}
+
+ossia::sc::explore_filter ossia::sc::read_filter(pyrslot *s)
+{
+    // OSSIA_ExploreFilter slots: tags, type, access, unit, critical, path
+    explore_filter filter;
+    if (IsNil(s)) return filter;
+
+    try     { check_argument_type(s, { "OSSIA_ExploreFilter" }); }
+    catch   ( const std::exception& e ) { throw; }
+
+    auto slots = slotRawObject(s)->slots;
+
+    if (!IsNil(slots))      filter.tags     = sc::read_vector<std::string>(slots, sc::read_string);
+    if (!IsNil(slots+1))    filter.type     = sc::read_type(slots+1);
+    if (!IsNil(slots+2))    filter.access   = sc::read_listed_attribute<access_mode>(slots+2, g_accessmap);
+    if (!IsNil(slots+3))    filter.unit     = sc::read_string(slots+3);
+    if (!IsNil(slots+4))    filter.critical = IsTrue(slots+4);
+    if (!IsNil(slots+5))    filter.path     = sc::read_string(slots+5);
+
+    return filter;
+}
+
+template<class T>
+std::vector<T> ossia::sc::read_vector(pyrslot *s, T (*getter_function)(pyrslot*))
+{
+    auto obj = slotRawObject(s);
+    std::vector<T> vector;
+
+    for     (int i = 0; i < obj->size; ++i)
+            vector.push_back(getter_function(obj->slots+i));
+
+    return  vector;
+}
+
+template<class T, class U>
+T ossia::sc::read_array(pyrslot *s, U (*getter_function)(pyrslot*))
+{
+    T array;
+    pyrobject* target;
+    auto classname = sc::read_classname(s);
+
+    if(     classname == "Array" || classname == "List")
+            target = slotRawObject(s);
+    else    target = slotRawObject(slotRawObject(s)->slots);
+
+    if      (array.size() != target->size) throw ARG_BAD_VALUE;
+
+    for     (int i = 0; i < target->size; ++i)
+            array[i] = getter_function(target->slots+i);
+
+    return  array;
+}
+
+ossia::value ossia::sc::read_value(pyrslot *s)
+{
+    auto vtype = sc::read_type(s);
+    switch( vtype )
+    {
+    case val_type::INT:  return ossia::value(read_float(s)); break; // allows int to float conversion in sc...
+    case val_type::BOOL: return ossia::value(IsTrue(s)); break;
+    case val_type::CHAR: return ossia::value(read_char(s)); break;
+    case val_type::FLOAT: return ossia::value(read_float(s)); break;
+    case val_type::LIST: return ossia::value(read_vector<ossia::value>(s, read_value)); break;
+    case val_type::VEC2F: return ossia::value(read_array<vec2f, float>(s, sc::read_float)); break;
+    case val_type::VEC3F: return ossia::value(read_array<vec3f, float>(s, sc::read_float)); break;
+    case val_type::VEC4F: return ossia::value(read_array<vec4f, float>(s, sc::read_float)); break;
+    case val_type::STRING:  return ossia::value(read_string(s)); break;
+    case val_type::IMPULSE: return ossia::impulse{}; break;
+    default: throw  ARG_WRONG_TYPE;
+    }
+
+    return ossia::value();
+}
+
+template<class T>
+std::string ossia::sc::format_listed_attribute
+(T attribute, boost::bimap<std::string, boost::bimaps::multiset_of<T>> target_map) noexcept
+{
+    typedef  boost::bimap<std::string, boost::bimaps::multiset_of<T>> bm_type;
+    typename bm_type::right_const_iterator r_iter = target_map.right.find(attribute);
+
+    if      (r_iter == target_map.right.end())
+            return "nil";
+    else    return (r_iter->second);
+}
+
+template<class T, class F>
+void ossia::sc::write_array(vmglobals *g, pyrslot *target,
+const T& values, void (*writer_func)(vmglobals*, pyrslot*, const F&)) noexcept
+{
+    int sz = values.size();
+    auto array = newPyrArray(g->gc, sz, 0, true);
+    SetObject(target, array);
+
+    for(int i = 0; i < sz; i++)
+    {
+        writer_func(g, array->slots+i, values[i]);
+        array->size++;
+    }
+}
+
+inline void ossia::sc::write_string(vmglobals *g, pyrslot *target, const std::string& string) noexcept
+{
+    PyrString*  str = newPyrString(g->gc, string.c_str(), 0, true);
+    SetObject   (target, str);
+}
+
+inline void ossia::sc::write_symbol(vmglobals *g, pyrslot *target, const std::string& string) noexcept
+{
+    SetSymbol   (target, getsym(string.c_str()));
+}
+
+void ossia::sc::write_value(vmglobals *g, pyrslot *target, const ossia::value& value) noexcept
+{
+    ossia::val_type vtype;
+    if(value.valid()) vtype = value.get_type();
+    else vtype = ossia::val_type::NONE;
+
+    switch ( vtype )
+    {
+    case ossia::val_type::IMPULSE:  SetNil(target); break;
+    case ossia::val_type::NONE:     SetNil(target); break;
+    case ossia::val_type::BOOL:     SetBool(target, value.get<bool>()); break;
+    case ossia::val_type::CHAR:     SetChar(target, value.get<char>()); break;
+    case ossia::val_type::FLOAT:    SetFloat(target, value.get<float>()); break;
+    case ossia::val_type::INT:      SetInt(target, value.get<int>()); break;
+    case ossia::val_type::STRING:   sc::write_string(g, target, value.get<std::string>()); break;
+    case ossia::val_type::LIST:     sc::write_array<std::vector<ossia::value>,ossia::value>(g, target, value.get<std::vector<ossia::value>>(), sc::write_value); break;
+    case ossia::val_type::VEC2F:    sc::write_array<vec2f,ossia::value>(g, target, value.get<vec2f>(), sc::write_value); break;
+    case ossia::val_type::VEC3F:    sc::write_array<vec3f,ossia::value>(g, target, value.get<vec3f>(), sc::write_value); break;
+    case ossia::val_type::VEC4F:    sc::write_array<vec4f,ossia::value>(g, target, value.get<vec4f>(), sc::write_value); break;
+    }
+}
+
+void send_to_class(vmglobals *g, const char* classname, const char* selector,
+                   const std::vector<ossia::value>& args)
+{
+    // to be called with the language lock held
+    if (!compiledOK) return;
+
+    g->canCallOS        = true;
+    ++g->sp;            SetObject(g->sp, getsym(classname)->u.classobj);
+
+    for (const auto& arg : args)
+    {
+        ++g->sp;        sc::write_value(g, g->sp, arg);
+    }
+
+    runInterpreter      (g, getsym(selector), args.size() + 1);
+    g->canCallOS        = false;
+}
+
+bool same_server(const net::zeroconf_server& a, const net::zeroconf_server& b)
+{
+    return a.name == b.name && a.host == b.host && a.port == b.port;
+}
+
+bool contains_server(const std::vector<net::zeroconf_server>& list, const net::zeroconf_server& server)
+{
+    return std::any_of(list.begin(), list.end(),
+                       [&] (const auto& other) { return same_server(server, other); });
+}
+
+ossia::sc::zeroconf_browser::~zeroconf_browser()
+{
+    g_exiting = true;
+    auto deadline = std::chrono::steady_clock::now() + SHUTDOWN_TIMEOUT;
+
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        m_state->stop = true;
+    }
+
+    m_state->condition.notify_one();
+    if (m_thread.joinable()) finish_thread(m_thread, m_state->done, deadline);
+}
+
+void ossia::sc::zeroconf_browser::start(change_callback on_change)
+{
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    if (m_thread.joinable()) return;
+
+    m_state->on_change  = std::move(on_change);
+    m_thread            = std::thread([shared = m_state] { run(shared); });
+}
+
+std::vector<net::zeroconf_server> ossia::sc::zeroconf_browser::devices()
+{
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    return m_state->devices;
+}
+
+void ossia::sc::zeroconf_browser::run(std::shared_ptr<state> shared)
+{
+    auto& st = *shared;
+    std::unique_lock<std::mutex> lock(st.mutex);
+
+    while (!st.stop)
+    {
+        // each browse blocks for the whole discovery timeout, hence this thread
+        lock.unlock();
+        auto found = net::list_oscquery_devices();
+        lock.lock();
+
+        if (st.stop) break;
+
+        std::vector<std::pair<net::zeroconf_server, bool>> changes;
+
+        for (const auto& server : found)
+            if (!contains_server(st.devices, server)) changes.emplace_back(server, true);
+
+        for (const auto& server : st.devices)
+            if (!contains_server(found, server)) changes.emplace_back(server, false);
+
+        st.devices = std::move(found);
+
+        // change callbacks take the language lock, which may be held by a thread reading the cache
+        for (const auto& change : changes)
+        {
+            if (st.stop) break;
+
+            lock.unlock();
+            st.on_change(change.first, change.second);
+            lock.lock();
+        }
+
+        st.condition.wait_for(lock, std::chrono::seconds(2), [&st] { return st.stop; });
+    }
+
+    st.done = true;
+}
+
+int pyr_zeroconf_explore(vmglobals *g, int n)
+{
+    // OSSIA_Device.pvOnZeroconf(name, host, port, appeared) runs the sc callbacks, if any
+    g_zeroconf.start([g] (const net::zeroconf_server& server, bool appeared)
+    {
+        if (!sc::lock_language()) return;
+        send_to_class(g, "OSSIA_Device", "pvOnZeroconf",
+                      { server.name, server.host, server.port, appeared });
+        gLangMutex.unlock();
+    });
+
+    // returns instantly with the devices found so far, empty until the first browse is done
+    auto list = g_zeroconf.devices();
+    std::vector<ossia::value> res;
+
+    for(auto& device : list)
+    {
+        std::vector<ossia::value> devaslist;
+        devaslist.push_back((ossia::value) device.name);
+        devaslist.push_back((ossia::value) device.host);
+        devaslist.push_back((ossia::value) device.port);
+        res.push_back(devaslist);
+    }
+
+    sc::write_value(g, g->sp, res);
+
+    return errNone;
+}
+
+int pyr_instantiate_device(vmglobals *g, int n)
+{
+    pyrslot *rcvr       = g->sp-2,
+            *pr_name    = g->sp-1,
+            *pr_pooled  = g->sp;
+
+    try      { ossia::sc::check_argument_type(pr_name, { "String", "Symbol" }); }
+    catch    ( const std::exception &e )
+    {
+        ERROTP      (e, ERR_HDR, "Device name argument.");
+        return      errFailed;
+    }
+
+    auto device_name        = sc::read_string(pr_name);
+    auto mpx_proto_ptr      = std::make_unique<multiplex_protocol>();
+    auto multiplex          = mpx_proto_ptr.get();
+    auto device             = new net::generic_device(std::move(mpx_proto_ptr), device_name);
+
+    // keeps binding-side caches in sync with local and remote removals
+    device->on_node_removing.connect<&on_node_removing>();
+    device->on_parameter_removing.connect<&on_parameter_removing>();
+    device->on_node_renamed.connect<&on_node_renamed>();
+    auto binding            = std::make_unique<device_binding>(*device);
+    if  (IsTrue(pr_pooled)) binding->pools = std::make_unique<node_pools>();
+    g_bindings[device]      = std::move(binding);
+
+    // devices keep their protocol in the handle table, no cast needed later on
+    SetInt(slotRawObject(rcvr)->slots, g_handles.insert(*device, device, multiplex));
+
+    return      errNone;
+}
+
+ossia::sc::path_filter::path_filter(std::vector<std::string> include, std::vector<std::string> exclude)
+    : m_include(std::move(include)), m_exclude(std::move(exclude)) {}
+
+bool ossia::sc::path_filter::matches(const std::string& address) const
+{
+    // same patterns as explore's path filter
+    auto match_any = [&address] (const std::vector<std::string>& patterns)
+    {
+        return std::any_of(patterns.begin(), patterns.end(), [&address] (const std::string& pattern)
+        {
+            return glob_match(pattern.c_str(), address.c_str());
+        });
+    };
+
+    return (m_include.empty() || match_any(m_include)) && !match_any(m_exclude);
+}
+
+bool ossia::sc::path_filter::allows(const net::node_base& node)
+{
+    // pushes may come from network threads as well as from sc
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto cached = m_cache.find(&node);
+    if  (cached != m_cache.end()) return cached->second;
+
+    bool allowed = matches(net::osc_parameter_string(node));
+    m_cache.emplace(&node, allowed);
+    return allowed;
+}
+
+void ossia::sc::path_filter::forget(const net::node_base& node)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cache.erase(&node);
+}
+
+void ossia::sc::path_filter::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_cache.clear();
+}
+
+class counting_sink final : public spdlog::sinks::base_sink<spdlog::details::null_mutex>
+{
+public:
+    explicit counting_sink(std::shared_ptr<protocol_stats> stats) : m_stats(std::move(stats)) {}
+
+protected:
+    // every message the protocol logs as inbound is one received message
+    void sink_it_(const spdlog::details::log_msg&) override { m_stats->messages_in++; }
+    void flush_() override {}
+
+private:
+    std::shared_ptr<protocol_stats> m_stats;
+};
+
+ossia::sc::counted_protocol::counted_protocol(std::unique_ptr<net::protocol_base> protocol,
+                                             std::shared_ptr<protocol_stats> stats,
+                                             std::shared_ptr<path_filter> filter)
+    : m_protocol(std::move(protocol)), m_stats(std::move(stats)), m_filter(std::move(filter))
+{
+    if (auto server = dynamic_cast<oscquery_server_protocol*>(m_protocol.get()))
+    {
+        m_stats->clients = 0;
+        server->onClientConnected.connect<&counted_protocol::on_client_connected>(this);
+        server->onClientDisconnected.connect<&counted_protocol::on_client_disconnected>(this);
+    }
+
+    // libossia protocols only report incoming messages to their inbound logger
+    if (!m_stats->transport)
+    {
+        m_inbound_counter = std::make_shared<counting_sink>(m_stats);
+        set_logger(m_protocol->get_logger());
+    }
+}
+
+ossia::sc::counted_protocol::~counted_protocol()
+{
+    if (auto server = dynamic_cast<oscquery_server_protocol*>(m_protocol.get()))
+    {
+        server->onClientConnected.disconnect<&counted_protocol::on_client_connected>(this);
+        server->onClientDisconnected.disconnect<&counted_protocol::on_client_disconnected>(this);
+    }
+}
+
+void ossia::sc::counted_protocol::on_client_connected(const std::string&)
+{
+    m_stats->clients++;
+}
+
+void ossia::sc::counted_protocol::on_client_disconnected(const std::string&)
+{
+    m_stats->clients--;
+}
+
+template<typename F>
+bool timed_push(protocol_stats& stats, F&& push)
+{
+    // encode time is the time spent in the protocol's push, serialisation included
+    auto start = std::chrono::steady_clock::now();
+    bool ok;
+
+    try     { ok = push(); }
+    catch   ( ... )
+    {
+        stats.errors++;
+        throw;
+    }
+
+    stats.encode_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now() - start).count();
+
+    if (ok) stats.messages_out++;
+    else    stats.errors++;
+
+    return ok;
+}
+
+bool ossia::sc::counted_protocol::push(const net::parameter_base& parameter, const ossia::value& v)
+{
+    // filtered out parameters are skipped silently, they are not errors
+    if (m_filter && !m_filter->allows(parameter.get_node())) return true;
+    return timed_push(*m_stats, [&] { return m_protocol->push(parameter, v); });
+}
+
+bool ossia::sc::counted_protocol::push_raw(const net::full_parameter_data& data)
+{
+    // raw pushes have no node to cache the result on
+    if (m_filter && !m_filter->matches(data.address)) return true;
+    return timed_push(*m_stats, [&] { return m_protocol->push_raw(data); });
+}
+
+bool ossia::sc::counted_protocol::push(const net::parameter_base& parameter, ossia::value&& v)
+{
+    if (m_filter && !m_filter->allows(parameter.get_node())) return true;
+    return timed_push(*m_stats, [&] { return m_protocol->push(parameter, std::move(v)); });
+}
+
+bool ossia::sc::counted_protocol::push_bundle(const std::vector<const net::parameter_base*>& parameters)
+{
+    // a bundle counts as one message per parameter it carries
+    std::vector<const net::parameter_base*> allowed;
+    allowed.reserve(parameters.size());
+
+    for (auto parameter : parameters)
+        if (!m_filter || m_filter->allows(parameter->get_node())) allowed.push_back(parameter);
+
+    if (allowed.empty()) return true;
+
+    bool ok = timed_push(*m_stats, [&] { return m_protocol->push_bundle(allowed); });
+    if  (ok) m_stats->messages_out += allowed.size() - 1;
+    return ok;
+}
+
+bool ossia::sc::counted_protocol::push_raw_bundle(const std::vector<net::full_parameter_data>& data)
+{
+    std::vector<net::full_parameter_data> allowed;
+    allowed.reserve(data.size());
+
+    for (const auto& message : data)
+        if (!m_filter || m_filter->matches(message.address)) allowed.push_back(message);
+
+    if (allowed.empty()) return true;
+
+    bool ok = timed_push(*m_stats, [&] { return m_protocol->push_raw_bundle(allowed); });
+    if  (ok) m_stats->messages_out += allowed.size() - 1;
+    return ok;
+}
+
+bool ossia::sc::counted_protocol::pull(net::parameter_base& parameter)
+{
+    return m_protocol->pull(parameter);
+}
+
+std::future<void> ossia::sc::counted_protocol::pull_async(net::parameter_base& parameter)
+{
+    return m_protocol->pull_async(parameter);
+}
+
+void ossia::sc::counted_protocol::request(net::parameter_base& parameter)
+{
+    m_protocol->request(parameter);
+}
+
+bool ossia::sc::counted_protocol::observe(net::parameter_base& parameter, bool enable)
+{
+    if (enable && m_filter && !m_filter->allows(parameter.get_node())) return false;
+    return m_protocol->observe(parameter, enable);
+}
+
+bool ossia::sc::counted_protocol::observe_quietly(net::parameter_base& parameter, bool enable)
+{
+    if (enable && m_filter && !m_filter->allows(parameter.get_node())) return false;
+    return m_protocol->observe_quietly(parameter, enable);
+}
+
+bool ossia::sc::counted_protocol::update(net::node_base& node)
+{
+    return m_protocol->update(node);
+}
+
+void ossia::sc::counted_protocol::set_logger(const net::network_logger& logger)
+{
+    if (!m_inbound_counter)
+    {
+        m_protocol->set_logger(logger);
+        return;
+    }
+
+    // the counting sink is kept in front of whatever inbound logger is set afterwards
+    std::vector<spdlog::sink_ptr> sinks { m_inbound_counter };
+    if (logger.inbound_logger)
+        sinks.insert(sinks.end(), logger.inbound_logger->sinks().begin(), logger.inbound_logger->sinks().end());
+
+    auto counted            = logger;
+    counted.inbound_logger  = std::make_shared<spdlog::logger>(m_stats->name + ".in", sinks.begin(), sinks.end());
+    counted.inbound_logger  ->set_level(spdlog::level::trace);
+    m_protocol->set_logger(counted);
+}
+
+const ossia::net::network_logger& ossia::sc::counted_protocol::get_logger() const noexcept
+{
+    return m_protocol->get_logger();
+}
+
+void ossia::sc::counted_protocol::set_device(net::device_base& device)
+{
+    m_protocol->set_device(device);
+}
+
+void ossia::sc::counted_protocol::stop()
+{
+    m_protocol->stop();
+}
+
+ossia::sc::counted_protocol& ossia::sc::expose(net::device_base& device, std::unique_ptr<net::protocol_base> protocol,
+                       const std::string& kind, std::shared_ptr<protocol_stats> stats,
+                       std::shared_ptr<path_filter> filter)
+{
+    if (!stats) stats = std::make_shared<protocol_stats>(kind);
+
+    // several protocols of the same kind are told apart by an index
+    if (auto binding = sc::get_binding(device))
+    {
+        if (!filter) filter = std::move(binding->pending_filter);
+        if (filter)  binding->filters.push_back(filter);
+
+        auto same_kind = std::count_if(binding->stats.begin(), binding->stats.end(), [&] (const auto& other)
+        {
+            return other->name == kind || other->name.rfind(kind + ".", 0) == 0;
+        });
+
+        if (same_kind) stats->name = kind + "." + std::to_string(same_kind);
+        binding->stats.push_back(stats);
+    }
+
+    auto counted    = std::make_unique<counted_protocol>(std::move(protocol), std::move(stats),
+                                                         std::move(filter));
+    auto& exposed   = *counted;
+
+    auto& multiplex = dynamic_cast<net::multiplex_protocol&>(device.get_protocol());
+    multiplex.expose_to(std::move(counted));
+    return exposed;
+}
+
+std::vector<std::string> read_patterns(pyrslot *s)
+{
+    std::vector<std::string> patterns;
+    if (IsNil(s)) return patterns;
+
+    if (sc::check_argument_type(s, { "String", "Symbol", "Array" }) != "Array")
+    {
+        patterns.push_back(sc::read_string(s));
+        return patterns;
+    }
+
+    auto array = slotRawObject(s);
+
+    for (int i = 0; i < array->size; ++i)
+    {
+        sc::check_argument_type(array->slots+i, { "String", "Symbol" });
+        patterns.push_back(sc::read_string(array->slots+i));
+    }
+
+    return patterns;
+}
+
+int pyr_device_set_expose_filter(vmglobals *g, int n)
+{
+    // applies to the next protocol exposed on this device
+    pyrslot     *rcvr           = g->sp-2,
+                *pr_include     = g->sp-1,
+                *pr_exclude     = g->sp;
+
+    std::vector<std::string> include, exclude;
+
+    try      { include = read_patterns(pr_include); }
+    catch    ( const std::exception &e )
+    {
+        ERROTP      (e, ERR_HDR, "Include argument, expected a String, Symbol or Array of them.");
+        return      errFailed;
+    }
+
+    try      { exclude = read_patterns(pr_exclude); }
+    catch    ( const std::exception &e )
+    {
+        ERROTP      (e, ERR_HDR, "Exclude argument, expected a String, Symbol or Array of them.");
+        return      errFailed;
+    }
+
+    auto binding = sc::get_binding(sc::get_device(rcvr));
+    if  (!binding) throw NODE_NOT_FOUND;
+
+    if  (include.empty() && exclude.empty()) binding->pending_filter.reset();
+    else binding->pending_filter = std::make_shared<path_filter>(std::move(include), std::move(exclude));
+
+    return errNone;
+}
+
+int pyr_expose_oscquery_server(vmglobals *g, int n)
+{
+    pyrslot  *rcvr           = g->sp-2,
+             *pr_osc_port    = g->sp-1,
+             *pr_ws_port     = g->sp;
+
+    try      { ossia::sc::check_argument_type(pr_osc_port, { "Integer" }); }
+    catch    ( const std::exception &e )
+    {
+        ERROTP      (e, ERR_HDR, "OSC Port argument.");
+        return      errFailed;
+    }
+
+    try      { ossia::sc::check_argument_type(pr_ws_port, { "Integer" }); }
+    catch    ( const std::exception &e )
+    {
+        ERROTP      (e, ERR_HDR, "WS Port argument.");
+        return      errFailed;
+    }
+
+    auto oscq_protocol = std::make_unique<oscquery_server_protocol>
+                         (sc::read_int(pr_osc_port), sc::read_int(pr_ws_port));    
+
+    sc::expose(sc::get_device(rcvr), std::move(oscq_protocol), "oscquery");
+
+    return               errNone;
+}
+
+bool ossia::sc::lock_language()
+{
+    // polled rather than blocking, so that giving up doesn't depend on the lock's holder
+    while (!g_exiting)
+    {
+        if (gLangMutex.try_lock()) return true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return false;
+}
+
+void ossia::sc::finish_thread(std::thread& thread, const std::atomic<bool>& done,
+                              std::chrono::steady_clock::time_point deadline)
+{
+    while (!done && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    if (done) thread.join();
+    else      thread.detach();
+}
+
+ossia::sc::background_jobs::~background_jobs()
+{
+    g_exiting = true;
+    auto deadline = std::chrono::steady_clock::now() + SHUTDOWN_TIMEOUT;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& worker : m_workers)
+        if (worker.thread.joinable()) finish_thread(worker.thread, *worker.done, deadline);
+}
+
+void ossia::sc::background_jobs::run(std::function<void()> job)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_workers.erase(std::remove_if(m_workers.begin(), m_workers.end(), [] (worker& w)
+    {
+        if (!*w.done) return false;
+        w.thread.join();
+        return true;
+    }), m_workers.end());
+
+    auto done = std::make_shared<std::atomic<bool>>(false);
+    m_workers.push_back({ std::thread([job = std::move(job), done]
+    {
+        job();
+        *done = true;
+    }), done });
+}
+
+void copy_node_data(const net::node_base& source, net::node_base& target)
+{
+    target.set_extended_attributes(source.get_extended_attributes());
+
+    auto sp = source.get_parameter();
+    auto tp = target.get_parameter();
+
+    if (!sp)
+    {
+        if (tp) target.remove_parameter();
+        return;
+    }
+
+    // an existing parameter is updated in place, keeping its callbacks
+    if      (!tp) tp = target.create_parameter(sp->get_value_type());
+    else if (tp->get_value_type() != sp->get_value_type()) tp->set_value_type(sp->get_value_type());
+
+    tp->set_access(sp->get_access());
+    tp->set_bounding(sp->get_bounding());
+    tp->set_domain(sp->get_domain());
+    tp->set_unit(sp->get_unit());
+    tp->set_repetition_filter(sp->get_repetition_filter());
+    tp->set_critical(sp->get_critical());
+    tp->set_value_quiet(sp->value());
+
+    // mirrored parameters are only subscribed to if the device says so
+    auto binding = sc::get_binding(target.get_device());
+    if  (binding && binding->listen == LISTEN_ALL) sc::update_listening(*tp);
+}
+
+bool same_node_data(const net::node_base& a, const net::node_base& b)
+{
+    if (net::get_description(a) != net::get_description(b) ||
+        net::get_tags(a) != net::get_tags(b)) return false;
+
+    auto pa = a.get_parameter();
+    auto pb = b.get_parameter();
+
+    if (!pa || !pb) return !pa && !pb;
+
+    return pa->get_value_type()         == pb->get_value_type()
+        && pa->get_access()             == pb->get_access()
+        && pa->get_bounding()           == pb->get_bounding()
+        && pa->get_domain()             == pb->get_domain()
+        && pa->get_unit()               == pb->get_unit()
+        && pa->get_repetition_filter()  == pb->get_repetition_filter()
+        && pa->get_critical()           == pb->get_critical()
+        && pa->value()                  == pb->value();
+}
+
+void ossia::sc::expand(net::node_base& node, int depth)
+{
+    auto binding = get_binding(node.get_device());
+    if  (!binding || !binding->shadow || depth == 0) return;
+
+    if (binding->expanded.insert(&node).second)
+    {
+        auto& shadow_root = binding->shadow->get_root_node();
+        auto  source = &node == &node.get_device().get_root_node()
+                     ? &shadow_root
+                     : net::find_node(shadow_root, net::osc_parameter_string(node));
+
+        // nodes created locally have no remote counterpart
+        // (the shadow already holds what is copied from it)
+        if (source)
+        {
+            if (binding->sync) binding->sync->pause(true);
+
+            for (const auto& child : source->children_copy())
+            {
+                auto target = node.find_child(child->get_name());
+                if  (!target) target = &sc::create_child(node, child->get_name());
+                copy_node_data(*child, *target);
+
+                // the shadow's value dates from the download, the current one is asked for
+                if (binding->mirror)
+                    if (auto parameter = target->get_parameter()) binding->mirror->request(*parameter);
+            }
+
+            if (binding->sync) binding->sync->pause(false);
+        }
+    }
+
+    if (depth == 1) return;
+    for (const auto& child : node.children_copy())
+        expand(*child, depth - 1);
+}
+
+void ossia::sc::set_shadow(device_binding& binding, net::device_base& device,
+                           std::shared_ptr<net::generic_device> shadow)
+{
+    // the previous sync refers to the previous shadow
+    binding.sync.reset();
+    binding.shadow = std::move(shadow);
+    if (binding.shadow) binding.sync = std::make_unique<shadow_sync>(device, *binding.shadow);
+}
+
+ossia::sc::shadow_sync::shadow_sync(net::device_base& device, net::device_base& shadow)
+    : m_device(device), m_shadow(shadow)
+{
+    m_device.on_node_created.connect<&shadow_sync::on_node_created>(this);
+    m_device.on_node_removing.connect<&shadow_sync::on_node_removing>(this);
+    m_device.on_node_renamed.connect<&shadow_sync::on_node_renamed>(this);
+    m_device.on_attribute_modified.connect<&shadow_sync::on_attribute_modified>(this);
+    m_device.on_parameter_created.connect<&shadow_sync::on_parameter_created>(this);
+    m_device.on_parameter_removing.connect<&shadow_sync::on_parameter_removing>(this);
+}
+
+ossia::sc::shadow_sync::~shadow_sync()
+{
+    m_device.on_node_created.disconnect<&shadow_sync::on_node_created>(this);
+    m_device.on_node_removing.disconnect<&shadow_sync::on_node_removing>(this);
+    m_device.on_node_renamed.disconnect<&shadow_sync::on_node_renamed>(this);
+    m_device.on_attribute_modified.disconnect<&shadow_sync::on_attribute_modified>(this);
+    m_device.on_parameter_created.disconnect<&shadow_sync::on_parameter_created>(this);
+    m_device.on_parameter_removing.disconnect<&shadow_sync::on_parameter_removing>(this);
+}
+
+ossia::net::node_base* ossia::sc::shadow_sync::counterpart(const net::node_base& node) const
+{
+    auto& root = m_shadow.get_root_node();
+    if  (&node == &m_device.get_root_node()) return &root;
+    return net::find_node(root, net::osc_parameter_string(node));
+}
+
+void ossia::sc::shadow_sync::on_node_created(net::node_base& node)
+{
+    if (m_paused) return;
+
+    auto parent = node.get_parent() ? counterpart(*node.get_parent()) : nullptr;
+    if  (!parent || parent->find_child(node.get_name())) return;
+
+    copy_node_data(node, *parent->create_child(node.get_name()));
+}
+
+void ossia::sc::shadow_sync::on_node_removing(const net::node_base& node)
+{
+    if (m_paused) return;
+
+    auto shadow = counterpart(node);
+    if  (shadow && shadow->get_parent()) shadow->get_parent()->remove_child(*shadow);
+}
+
+void ossia::sc::shadow_sync::on_node_renamed(net::node_base& node, std::string old_name)
+{
+    if (m_paused) return;
+
+    auto parent = node.get_parent() ? counterpart(*node.get_parent()) : nullptr;
+    auto shadow = parent ? parent->find_child(old_name) : nullptr;
+    if  (shadow) shadow->set_name(node.get_name());
+}
+
+void ossia::sc::shadow_sync::on_attribute_modified(const net::node_base& node, ossia::string_view attribute)
+{
+    if (m_paused) return;
+    if (auto shadow = counterpart(node)) copy_node_data(node, *shadow);
+}
+
+void ossia::sc::shadow_sync::on_parameter_created(const net::parameter_base& parameter)
+{
+    on_attribute_modified(parameter.get_node(), {});
+}
+
+void ossia::sc::shadow_sync::on_parameter_removing(const net::parameter_base& parameter)
+{
+    if (m_paused) return;
+
+    auto shadow = counterpart(parameter.get_node());
+    if  (shadow && shadow->get_parameter()) shadow->remove_parameter();
+}
+
+std::size_t count_nodes(const net::node_base& node)
+{
+    std::size_t count = 1;
+    for (const auto& child : node.children_copy())
+        count += count_nodes(*child);
+    return count;
+}
+
+constexpr std::size_t MIRROR_BATCH_SIZE = 512;
+
+struct namespace_cache_header
+{
+    char        magic[4];
+    uint32_t    version;
+    uint64_t    hash;
+    uint64_t    length;
+};
+
+constexpr char      NAMESPACE_CACHE_MAGIC[4] = { 'O', 'S', 'N', 'C' };
+constexpr uint32_t  NAMESPACE_CACHE_VERSION = 2;
+
+constexpr uint64_t  FNV_OFFSET_BASIS = 14695981039346656037ull;
+
+uint64_t fnv1a(const char* data, std::size_t size, uint64_t hash = FNV_OFFSET_BASIS) noexcept
+{
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+uint64_t structure_hash(const rapidjson::Value& json, uint64_t hash = FNV_OFFSET_BASIS) noexcept
+{
+    // names and attributes only: current values change all the time on a live remote,
+    // and would otherwise make every connection look like a namespace change
+    auto tag = static_cast<char>(json.GetType());
+    hash = fnv1a(&tag, 1, hash);
+
+    if (json.IsObject())
+    {
+        for (auto it = json.MemberBegin(); it != json.MemberEnd(); ++it)
+        {
+            if  (it->name == "VALUE") continue;
+            hash = fnv1a(it->name.GetString(), it->name.GetStringLength(), hash);
+            hash = structure_hash(it->value, hash);
+        }
+    }
+    else if (json.IsArray())
+    {
+        for (const auto& element : json.GetArray())
+            hash = structure_hash(element, hash);
+    }
+    else if (json.IsString())
+        hash = fnv1a(json.GetString(), json.GetStringLength(), hash);
+    else if (json.IsNumber())
+    {
+        auto number = json.GetDouble();
+        hash = fnv1a(reinterpret_cast<const char*>(&number), sizeof(number), hash);
+    }
+
+    return hash;
+}
+
+std::shared_ptr<net::generic_device> read_namespace_cache(const std::string& path, uint64_t& hash)
+{
+    // the file is mapped and parsed in place, a missing or corrupt cache is a plain miss
+    namespace bip = boost::interprocess;
+
+    try
+    {
+        bip::file_mapping   file(path.c_str(), bip::read_only);
+        bip::mapped_region  region(file, bip::read_only);
+
+        auto data = static_cast<const char*>(region.get_address());
+        auto size = region.get_size();
+
+        namespace_cache_header header;
+        if  (size < sizeof(header)) return nullptr;
+        std::memcpy(&header, data, sizeof(header));
+
+        if (std::memcmp(header.magic, NAMESPACE_CACHE_MAGIC, 4) ||
+            header.version != NAMESPACE_CACHE_VERSION ||
+            header.length != size - sizeof(header)) return nullptr;
+
+        rapidjson::Document doc;
+        doc.Parse(data + sizeof(header), header.length);
+        if (doc.HasParseError()) return nullptr;
+
+        auto device = std::make_shared<net::generic_device>(std::make_unique<multiplex_protocol>(), "cache");
+        ossia::oscquery::json_parser::parse_namespace(device->get_root_node(), doc);
+
+        hash = header.hash;
+        return device;
+    }
+    catch   ( const std::exception &e ) { return nullptr; }
+}
+
+void write_namespace_cache(const std::string& path, const std::string& json, uint64_t hash)
+{
+    namespace_cache_header header;
+    std::memcpy(header.magic, NAMESPACE_CACHE_MAGIC, 4);
+    header.version  = NAMESPACE_CACHE_VERSION;
+    header.hash     = hash;
+    header.length   = json.size();
+
+    // written aside then renamed over the previous file, which replaces it atomically,
+    // so that a concurrent reader sees either the old or the new cache, never none or half
+    auto tmp = path + ".tmp";
+    {
+        std::ofstream ofs(tmp, std::ios::binary | std::ios::trunc);
+        ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        ofs.write(json.data(), json.size());
+        if (!ofs) return;
+    }
+
+    if (std::rename(tmp.c_str(), path.c_str()))
+        std::remove(tmp.c_str());
+}
+
+struct namespace_delta
+{
+    std::vector<std::string> added;
+    std::vector<std::string> modified;
+    std::vector<std::string> removed;
+};
+
+void diff_namespaces(const net::node_base& before, const net::node_base& after,
+                     const std::string& path, namespace_delta& delta)
+{
+    auto before_children = before.children_copy();
+
+    for (const auto& child : after.children_copy())
+    {
+        auto child_path = path + '/' + child->get_name();
+        auto previous   = before.find_child(child->get_name());
+
+        if (!previous)
+        {
+            delta.added.push_back(child_path);
+            continue;
+        }
+
+        if (!same_node_data(*previous, *child)) delta.modified.push_back(child_path);
+        diff_namespaces(*previous, *child, child_path, delta);
+    }
+
+    for (const auto& child : before_children)
+    {
+        if (!after.find_child(child->get_name()))
+            delta.removed.push_back(path + '/' + child->get_name());
+    }
+}
+
+void copy_subtree(const net::node_base& source, net::node_base& target)
+{
+    copy_node_data(source, target);
+
+    for (const auto& child : source.children_copy())
+    {
+        auto target_child = target.find_child(child->get_name());
+        if  (!target_child) target_child = &sc::create_child(target, child->get_name());
+        copy_subtree(*child, *target_child);
+    }
+}
+
+void apply_namespace_delta(net::generic_device& device, const net::node_base& remote,
+                           const namespace_delta& delta, bool lazy)
+{
+    // only touches what changed, lazy mirrors only what was already materialised
+    auto  binding   = sc::get_binding(device);
+    auto& root      = device.get_root_node();
+
+    for (const auto& path : delta.removed)
+    {
+        if (auto node = net::find_node(root, path))
+            node->get_parent()->remove_child(*node);
+    }
+
+    for (const auto& path : delta.modified)
+    {
+        auto node   = net::find_node(root, path);
+        auto source = net::find_node(const_cast<net::node_base&>(remote), path);
+        if  (node && source) copy_node_data(*source, *node);
+    }
+
+    for (const auto& path : delta.added)
+    {
+        auto separator  = path.rfind('/');
+        auto name       = path.substr(separator + 1);
+        auto parent     = separator ? net::find_node(root, path.substr(0, separator)) : &root;
+        auto source     = net::find_node(const_cast<net::node_base&>(remote), path);
+        if  (!parent || !source) continue;
+
+        if (lazy && !binding->expanded.count(parent)) continue;
+
+        auto node = parent->find_child(name);
+        if  (!node) node = &sc::create_child(*parent, name);
+
+        if  (lazy) copy_node_data(*source, *node);
+        else copy_subtree(*source, *node);
+    }
+}
+
+bool populate_mirror(vmglobals *g, net::generic_device* device, const std::atomic<bool>& alive,
+                     std::shared_ptr<net::generic_device> source, int id, bool lazy)
+{
+    // called with the language lock held, which is released between batches,
+    // returns false if the device was freed meanwhile
+    auto total = count_nodes(source->get_root_node()) - 1;
+    std::size_t done = 0;
+
+    if (lazy)
+    {
+        auto& root = device->get_root_node();
+        sc::set_shadow(*sc::get_binding(*device), *device, std::move(source));
+        sc::expand(root, 1);
+
+        done = root.children_copy().size();
+        send_to_class(g, "OSSIA_Device", "pvOnMirrorProgress",
+                      { id, static_cast<int>(done), static_cast<int>(total) });
+        return true;
+    }
+
+    // a batch is MIRROR_BATCH_SIZE created nodes, frames keep their position
+    // so that a node with many children is spread over several batches
+    struct frame
+    {
+        std::vector<net::node_base*>    children;
+        std::size_t                     index;
+        net::node_base*                 target;
+    };
+
+    std::vector<frame> stack;
+    stack.push_back({ source->get_root_node().children_copy(), 0, &device->get_root_node() });
+
+    while (!stack.empty())
+    {
+        for (std::size_t batch = 0; batch < MIRROR_BATCH_SIZE && !stack.empty(); )
+        {
+            auto& top = stack.back();
+            if (top.index == top.children.size())
+            {
+                stack.pop_back();
+                continue;
+            }
+
+            auto child  = top.children[top.index++];
+            auto parent = top.target;
+
+            auto target = parent->find_child(child->get_name());
+            if  (!target) target = &sc::create_child(*parent, child->get_name());
+
+            copy_node_data(*child, *target);
+            done++;
+            batch++;
+
+            stack.push_back({ child->children_copy(), 0, target });
+        }
+
+        send_to_class(g, "OSSIA_Device", "pvOnMirrorProgress",
+                      { id, static_cast<int>(done), static_cast<int>(total) });
+
+        // let the interpreter run between batches
+        gLangMutex.unlock();
+        std::this_thread::yield();
+        gLangMutex.lock();
+
+        if (!alive || g_exiting) return false;
+    }
+
+    return true;
+}
+
+void load_mirror(vmglobals *g, net::generic_device* device, net::multiplex_protocol* multiplex,
+                 std::shared_ptr<std::atomic<bool>> alive, std::string host, int id, bool lazy,
+                 std::string cache_path, std::shared_ptr<path_filter> filter)
+{
+    // connection and namespace download don't involve sc at all: the remote tree
+    // is first built into a scratch device, then copied into ours in batches
+    // while holding the language lock, which is released in between
+    // (lazy mirrors keep the scratch device and only copy what gets used)
+    // with a cache, the previous namespace is loaded from disk first,
+    // and only the differences with the remote one are applied afterwards
+    uint64_t cached_hash = 0;
+    std::shared_ptr<net::generic_device> cached;
+    if (!cache_path.empty()) cached = read_namespace_cache(cache_path, cached_hash);
+
+    if (cached)
+    {
+        if (!sc::lock_language()) return;
+
+        if (*alive && populate_mirror(g, device, *alive, cached, id, lazy))
+            send_to_class(g, "OSSIA_Device", "pvOnMirrorDone", { id, true });
+
+        gLangMutex.unlock();
+    }
+
+    std::unique_ptr<oscquery_mirror_protocol> mirror;
+    auto remote = std::make_shared<net::generic_device>(std::make_unique<multiplex_protocol>(), "remote");
+    bool ok = true;
+
+    try
+    {
+        mirror = std::make_unique<oscquery_mirror_protocol>(host);
+        ok     = mirror->update(remote->get_root_node());
+    }
+    catch   ( const std::exception &e )
+    {
+        std::cout << HDR << ERR_HDR << e.what() << " (mirror of " << host << ")" << std::endl;
+        ok = false;
+    }
+
+    std::string json;
+    uint64_t hash = 0;
+
+    if (ok && !cache_path.empty())
+    {
+        auto buffer = ossia::oscquery::json_writer::query_namespace(remote->get_root_node());
+        json.assign(buffer.GetString(), buffer.GetSize());
+
+        rapidjson::Document doc;
+        doc.Parse(json.data(), json.size());
+        hash = structure_hash(doc);
+    }
+
+    bool changed = ok && (!cached || hash != cached_hash);
+
+    // computed out of the lock, neither tree belongs to sc
+    namespace_delta delta;
+    if (cached && changed)
+        diff_namespaces(cached->get_root_node(), remote->get_root_node(), "", delta);
+
+    if (!sc::lock_language()) return;
+
+    if (*alive)
+    {
+        if (ok) sc::get_binding(*device)->mirror =
+                &sc::expose(*device, std::move(mirror), "oscquery_mirror", nullptr, filter);
+
+        if (!cached)
+        {
+            ok = ok && populate_mirror(g, device, *alive, remote, id, lazy);
+            if (*alive && !g_exiting) send_to_class(g, "OSSIA_Device", "pvOnMirrorDone", { id, ok });
+        }
+        else if (changed)
+        {
+            if (lazy) sc::set_shadow(*sc::get_binding(*device), *device, remote);
+            apply_namespace_delta(*device, remote->get_root_node(), delta, lazy);
+        }
+    }
+
+    gLangMutex.unlock();
+
+    if (changed && !cache_path.empty()) write_namespace_cache(cache_path, json, hash);
+}
+
+int pyr_expose_oscquery_mirror(vmglobals *g, int n)
+{
+    // returns immediately, the device is filled in from a background thread
+    pyrslot     *rcvr       = g->sp-4,
+                *pyr_host   = g->sp-3,
+                *pr_id      = g->sp-2,
+                *pr_lazy    = g->sp-1,
+                *pr_cache   = g->sp;
+
+    try      { ossia::sc::check_argument_type(pyr_host, { "String", "Symbol" }); }
+    catch    ( const std::exception &e )
+    {
+        ERROTP      (e, ERR_HDR, "Host Address argument.");
+        return      errFailed;
+    }
+
+    try      { ossia::sc::check_argument_type(pr_id, { "Integer" }); }
+    catch    ( const std::exception &e )
+    {
+        ERROTP      (e, ERR_HDR, "Mirror load id argument.");
+        return      errFailed;
+    }
+
+    if (!IsNil(pr_cache))
+    {
+        try      { ossia::sc::check_argument_type(pr_cache, { "String", "Symbol" }); }
+        catch    ( const std::exception &e )
+        {
+            ERROTP      (e, ERR_HDR, "Cache path argument.");
+            return      errFailed;
+        }
+    }
+
+    auto  host      = sc::read_string(pyr_host);
+    auto  id        = slotRawInt(pr_id);
+    auto& device    = sc::get_device(rcvr);
+    auto  multiplex = &sc::get_multiplex(rcvr);
+    auto  alive     = sc::get_binding(device)->alive;
+    bool  lazy      = IsTrue(pr_lazy);
+    auto  cache     = IsNil(pr_cache) ? std::string() : sc::read_string(pr_cache);
+
+    // the protocol is only exposed once connected, the filter is taken now
+    auto  filter    = std::move(sc::get_binding(device)->pending_filter);
+
+    g_jobs.run([g, device = &device, multiplex, alive, host, id, lazy, cache, filter]
+    {
+        load_mirror(g, device, multiplex, alive, host, id, lazy, cache, filter);
+    });
+
+    return errNone;
+}
+
+int pyr_expose_minuit(vmglobals *g, int n)
+{
+    pyrslot     *rcvr               = g->sp-3,
+                *pyr_remote_ip      = g->sp-2,
+                *pyr_remote_port    = g->sp-1,
+                *pyr_local_port     = g->sp;
+
+    try      { ossia::sc::check_argument_type(pyr_remote_ip, { "String", "Symbol" }); }
+    catch    ( const std::exception &e )
+    {
+        ERROTP      (e, ERR_HDR, "Remote IP argument.");
+        return      errFailed;
+    }
+
+    try      { ossia::sc::check_argument_type(pyr_remote_port, { "Integer" }); }
+    catch    ( const std::exception &e )
+    {
+        ERROTP      (e, ERR_HDR, "Remote OSCPort argument.");
+        return      errFailed;
+    }
+
+    try      { ossia::sc::check_argument_type(pyr_local_port, { "Integer" }); }
+    catch    ( const std::exception &e )
+    {
+        ERROTP      (e, ERR_HDR, "Local OSCPort argument.");
+        return      errFailed;
+    }
+
+    auto device_name = sc::get_device(rcvr).get_name();
+
+    auto minuit_proto = std::make_unique<minuit_protocol>(
+                        device_name,
+                        sc::read_string(pyr_remote_ip),
+                        sc::read_int(pyr_remote_port),
+                        sc::read_int(pyr_local_port));
+
+    sc::expose(sc::get_device(rcvr), std::move(minuit_proto), "minuit");
+
+    return errNone;
+}
+
+#ifdef OSSIA_SC_DATAGRAM_SOCKETS
+struct osc_writer
+{
+    oscpack::OutboundPacketStream& stream;
+
+    void operator()(ossia::impulse) const {}
+    void operator()(int32_t v) const { stream << v; }
+    void operator()(float v) const { stream << v; }
+    void operator()(bool v) const { stream << v; }
+    void operator()(char v) const { stream << v; }
+    void operator()(const std::string& v) const { stream << v.c_str(); }
+
+    template<std::size_t N>
+    void operator()(const std::array<float, N>& v) const
+    {
+        for (auto f : v) stream << f;
+    }
+
+    void operator()(const std::vector<ossia::value>& v) const
+    {
+        for (const auto& element : v) element.apply(*this);
+    }
+
+    void operator()() const {}
+};
+
+ossia::value read_osc_arguments(const oscpack::ReceivedMessage& message)
+{
+    std::vector<ossia::value> values;
+    values.reserve(message.ArgumentCount());
+
+    for (auto it = message.ArgumentsBegin(); it != message.ArgumentsEnd(); ++it)
+    {
+        switch(it->TypeTag())
+        {
+        case oscpack::INT32_TYPE_TAG:   values.emplace_back(it->AsInt32Unchecked()); break;
+        case oscpack::INT64_TYPE_TAG:   values.emplace_back(int32_t(it->AsInt64Unchecked())); break;
+        case oscpack::FLOAT_TYPE_TAG:   values.emplace_back(it->AsFloatUnchecked()); break;
+        case oscpack::DOUBLE_TYPE_TAG:  values.emplace_back(float(it->AsDoubleUnchecked())); break;
+        case oscpack::CHAR_TYPE_TAG:    values.emplace_back(it->AsCharUnchecked()); break;
+        case oscpack::TRUE_TYPE_TAG:    values.emplace_back(true); break;
+        case oscpack::FALSE_TYPE_TAG:   values.emplace_back(false); break;
+        case oscpack::STRING_TYPE_TAG:  values.emplace_back(std::string(it->AsStringUnchecked())); break;
+        case oscpack::SYMBOL_TYPE_TAG:  values.emplace_back(std::string(it->AsSymbolUnchecked())); break;
+        default: break; // nil, blobs, midi etc. are skipped
+        }
+    }
+
+    switch(values.size())
+    {
+    case 0:     return ossia::impulse{};
+    case 1:     return std::move(values[0]);
+    default:    return values;
+    }
+}
+
+ossia::sc::batched_osc_protocol::batched_osc_protocol(const std::string& remote_ip,
+                                                       uint16_t remote_port, uint16_t local_port,
+                                                       std::shared_ptr<protocol_stats> stats)
+    : m_stats(std::move(stats)), m_inbox(BATCH_SIZE), m_outbox(BATCH_SIZE)
+{
+    addrinfo hints {}, *remote = nullptr;
+    hints.ai_family     = AF_INET;
+    hints.ai_socktype   = SOCK_DGRAM;
+
+    auto port = std::to_string(remote_port);
+    if  (getaddrinfo(remote_ip.c_str(), port.c_str(), &hints, &remote) || !remote)
+         throw std::runtime_error("could not resolve remote address " + remote_ip);
+
+    std::memcpy(&m_remote, remote->ai_addr, remote->ai_addrlen);
+    m_remote_length = remote->ai_addrlen;
+    m_remote_name   = remote_ip + ":" + port;
+    freeaddrinfo(remote);
+
+    sockaddr_in local {};
+    local.sin_family        = AF_INET;
+    local.sin_addr.s_addr   = htonl(INADDR_ANY);
+    local.sin_port          = htons(local_port);
+
+    open(AF_INET, reinterpret_cast<sockaddr*>(&local), sizeof(local));
+}
+
+ossia::sc::batched_osc_protocol::batched_osc_protocol(const std::string& local_path,
+                                                       const std::string& remote_path,
+                                                       std::shared_ptr<protocol_stats> stats)
+    : m_stats(std::move(stats)), m_inbox(BATCH_SIZE), m_outbox(BATCH_SIZE)
+{
+    sockaddr_un local {}, remote {};
+
+    if (local_path.size() >= sizeof(local.sun_path) || remote_path.size() >= sizeof(remote.sun_path))
+        throw std::runtime_error("socket path too long");
+
+    local.sun_family    = AF_UNIX;
+    remote.sun_family   = AF_UNIX;
+    std::strcpy(local.sun_path, local_path.c_str());
+    std::strcpy(remote.sun_path, remote_path.c_str());
+
+    std::memcpy(&m_remote, &remote, sizeof(remote));
+    m_remote_length = sizeof(remote);
+    m_remote_name   = remote_path;
+
+    // a socket file left over by a previous session would make bind fail,
+    // anything else at that path is not ours to remove
+    struct stat existing;
+    if (lstat(local_path.c_str(), &existing) == 0)
+    {
+        if (!S_ISSOCK(existing.st_mode))
+            throw std::runtime_error(local_path + " exists and is not a socket");
+        unlink(local_path.c_str());
+    }
+
+    open(AF_UNIX, reinterpret_cast<sockaddr*>(&local), sizeof(local));
+    m_local_path = local_path;
+}
+
+void ossia::sc::batched_osc_protocol::open(int family, const sockaddr* local, socklen_t length)
+{
+    m_stats->transport      = true;
+    m_stats->queue_depth    = 0;
+
+    m_socket = socket(family, SOCK_DGRAM, 0);
+    if  (m_socket < 0) throw std::runtime_error("could not create datagram socket");
+
+    // every send and receive is non-blocking already, this makes sure none can be missed:
+    // a unix socket peer that stops reading would otherwise stall the sender indefinitely
+    fcntl(m_socket, F_SETFL, fcntl(m_socket, F_GETFL, 0) | O_NONBLOCK);
+
+    if (family == AF_INET)
+    {
+        int reuse = 1;
+        setsockopt(m_socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    }
+
+    if (bind(m_socket, local, length) < 0)
+    {
+        close(m_socket);
+        throw std::runtime_error("could not bind datagram socket");
+    }
+
+    m_receiver  = std::thread([this] { receive(); });
+    m_sender    = std::thread([this] { send(); });
+}
+
+ossia::sc::batched_osc_protocol::~batched_osc_protocol()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+
+    m_condition.notify_all();
+    m_receiver.join();
+    m_sender.join();
+    close(m_socket);
+
+    struct stat existing;
+    if (!m_local_path.empty() && lstat(m_local_path.c_str(), &existing) == 0 && S_ISSOCK(existing.st_mode))
+        unlink(m_local_path.c_str());
+}
+
+template<typename Parameter>
+ossia::value bounded_value(const Parameter& parameter, const ossia::value& v)
+{
+    // an invalid result means the value is out of a 'low', 'high' or 'both' domain
+    if (parameter.get_bounding() == ossia::bounding_mode::FREE) return v;
+    return ossia::apply_domain(v, parameter.get_domain(), parameter.get_bounding());
+}
+
+bool ossia::sc::batched_osc_protocol::push(const net::parameter_base& parameter, const ossia::value& v)
+{
+    // write-only parameters are only set by remotes, they are not sent back
+    if (parameter.get_access() == ossia::access_mode::SET) return false;
+
+    auto value = bounded_value(parameter, v);
+    if  (!value.valid()) return false;
+
+    return enqueue(net::osc_parameter_string(parameter), value,
+                   parameter.get_repetition_filter() == ossia::repetition_filter::ON);
+}
+
+bool ossia::sc::batched_osc_protocol::push_raw(const net::full_parameter_data& data)
+{
+    if (data.get_access() == ossia::access_mode::SET) return false;
+
+    auto value = bounded_value(data, data.value());
+    if  (!value.valid()) return false;
+
+    return enqueue(data.address, value, data.get_repetition_filter() == ossia::repetition_filter::ON);
+}
+
+bool ossia::sc::batched_osc_protocol::enqueue(const std::string& address, const ossia::value& v,
+                                              bool filter_repetitions)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_stop) return false;
+
+    // repeated values are dropped before they take a slot
+    if (filter_repetitions)
+    {
+        auto last = m_last_pushed.find(address);
+        if  (last != m_last_pushed.end() && last->second == v) return true;
+    }
+
+    // pushers run on the interpreter thread, which must never wait for the network:
+    // while the sender thread is stuck with a full batch, new messages are dropped
+    if (m_pending == BATCH_SIZE)
+    {
+        m_stats->dropped++;
+        return false;
+    }
+
+    auto& slot = m_outbox[m_pending];
+
+    try
+    {
+        oscpack::OutboundPacketStream stream(slot.data, DATAGRAM_SIZE);
+        stream << oscpack::BeginMessage(address.c_str());
+        v.apply(osc_writer{stream});
+        stream << oscpack::EndMessage;
+        slot.size = stream.Size();
+    }
+    catch   ( const std::exception& )
+    {
+        // the message doesn't fit in a datagram slot
+        m_stats->errors++;
+        return false;
+    }
+
+    // only remembered once queued, so that a dropped value is sent again next time
+    if (filter_repetitions) m_last_pushed[address] = v;
+
+    m_stats->queue_depth = ++m_pending;
+    lock.unlock();
+    m_condition.notify_all();
+    return true;
+}
+
+void ossia::sc::batched_osc_protocol::send()
+{
+    std::vector<datagram>   batch(BATCH_SIZE);
+#ifdef __linux__
+    std::vector<mmsghdr>    headers(BATCH_SIZE);
+    std::vector<iovec>      buffers(BATCH_SIZE);
+#endif
+
+    while (true)
+    {
+        std::size_t count;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_stop || m_pending > 0; });
+            if (m_stop) return;
+
+            // pushers keep filling the other buffer while this one is sent
+            std::swap(batch, m_outbox);
+            count       = m_pending;
+            m_pending   = 0;
+            m_stats->queue_depth = 0;
+        }
+
+        m_condition.notify_all();
+
+        std::size_t sent = 0;
+
+#ifdef __linux__
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            buffers[i]                      = { batch[i].data, batch[i].size };
+            headers[i].msg_hdr              = {};
+            headers[i].msg_hdr.msg_name     = &m_remote;
+            headers[i].msg_hdr.msg_namelen  = m_remote_length;
+            headers[i].msg_hdr.msg_iov      = &buffers[i];
+            headers[i].msg_hdr.msg_iovlen   = 1;
+        }
+
+        while (sent < count)
+        {
+            int result = sendmmsg(m_socket, headers.data() + sent, count - sent, MSG_DONTWAIT);
+            if (result <= 0) break;
+
+            for (int i = 0; i < result; ++i) m_stats->bytes_out += headers[sent + i].msg_len;
+            sent += result;
+        }
+#else
+        for (; sent < count; ++sent)
+        {
+            auto result = sendto(m_socket, batch[sent].data, batch[sent].size, MSG_DONTWAIT,
+                                 reinterpret_cast<const sockaddr*>(&m_remote), m_remote_length);
+            if (result < 0) break;
+            m_stats->bytes_out += result;
+        }
+#endif
+
+        // e.g. the local peer isn't listening (yet), or isn't reading fast enough (EAGAIN,
+        // sends never wait): the rest of the batch is dropped, which is reported once per
+        // outage rather than per message
+        if (sent < count)
+        {
+            m_stats->errors += count - sent;
+
+            if (!m_unreachable)
+            {
+                m_unreachable = true;
+                std::cout << HDR << WRN_HDR << "could not send to " << m_remote_name
+                          << " (" << std::strerror(errno) << "), messages are dropped until it is reachable."
+                          << std::endl;
+            }
+        }
+        else if (m_unreachable)
+        {
+            m_unreachable = false;
+            std::cout << HDR << m_remote_name << " is reachable again." << std::endl;
+        }
+    }
+}
+
+void ossia::sc::batched_osc_protocol::receive()
+{
+#ifdef __linux__
+    std::vector<mmsghdr>    headers(BATCH_SIZE);
+    std::vector<iovec>      buffers(BATCH_SIZE);
+
+    for (std::size_t i = 0; i < BATCH_SIZE; ++i)
+    {
+        buffers[i]                      = { m_inbox[i].data, DATAGRAM_SIZE };
+        headers[i].msg_hdr              = {};
+        headers[i].msg_hdr.msg_iov      = &buffers[i];
+        headers[i].msg_hdr.msg_iovlen   = 1;
+    }
+#endif
+
+    pollfd descriptor { m_socket, POLLIN, 0 };
+
+    // polling with a timeout lets the destructor stop the thread
+    while (!m_stop)
+    {
+        if (poll(&descriptor, 1, 100) <= 0) continue;
+
+#ifdef __linux__
+        int count = recvmmsg(m_socket, headers.data(), BATCH_SIZE, MSG_DONTWAIT, nullptr);
+        for (int i = 0; i < count; ++i)
+        {
+            m_stats->messages_in++;
+            m_stats->bytes_in += headers[i].msg_len;
+            dispatch(m_inbox[i].data, headers[i].msg_len);
+        }
+#else
+        // drained one datagram at a time
+        for (std::size_t i = 0; i < BATCH_SIZE; ++i)
+        {
+            auto size = recv(m_socket, m_inbox[0].data, DATAGRAM_SIZE, MSG_DONTWAIT);
+            if  (size < 0) break;
+
+            m_stats->messages_in++;
+            m_stats->bytes_in += size;
+            dispatch(m_inbox[0].data, size);
+        }
+#endif
+    }
+}
+
+void dispatch_osc_message(net::node_base& root, const oscpack::ReceivedMessage& message)
+{
+    auto node = net::find_node(root, message.AddressPattern());
+    if  (!node) return;
+
+    // read-only parameters can't be set from the network
+    auto param = node->get_parameter();
+    if  (!param || param->get_access() == ossia::access_mode::GET) return;
+
+    auto value = bounded_value(*param, ossia::convert(read_osc_arguments(message), param->get_value_type()));
+    if  (!value.valid()) return;
+
+    if (param->get_repetition_filter() == ossia::repetition_filter::ON && param->value() == value)
+        return;
+
+    param->set_value(std::move(value));
+}
+
+void dispatch_osc_bundle(net::node_base& root, const oscpack::ReceivedBundle& bundle)
+{
+    for (auto it = bundle.ElementsBegin(); it != bundle.ElementsEnd(); ++it)
+    {
+        if   (it->IsBundle()) dispatch_osc_bundle(root, oscpack::ReceivedBundle(*it));
+        else dispatch_osc_message(root, oscpack::ReceivedMessage(*it));
+    }
+}
+
+void ossia::sc::batched_osc_protocol::dispatch(const char* data, std::size_t size)
+{
+    if (!m_device) return;
+
+    try
+    {
+        oscpack::ReceivedPacket packet(data, size);
+        auto& root = m_device->get_root_node();
+
+        if   (packet.IsBundle()) dispatch_osc_bundle(root, oscpack::ReceivedBundle(packet));
+        else dispatch_osc_message(root, oscpack::ReceivedMessage(packet));
+    }
+    catch   ( const std::exception& )
+    {
+        // malformed packets are dropped
+        m_stats->errors++;
+    }
+}
+#endif
+
+int pyr_expose_osc(vmglobals *g, int n)
+{
+    pyrslot     *rcvr               = g->sp-4,
+                *pyr_remote_ip      = g->sp-3,
+                *pyr_remote_port    = g->sp-2,
+                *pyr_local_port     = g->sp-1,
+                *pyr_batched        = g->sp;
+
+    try      { ossia::sc::check_argument_type(pyr_remote_ip, { "String", "Symbol" }); }
+    catch    ( const std::exception &e )
+    {
+        ERROTP      (e, ERR_HDR, "Remote IP argument.");
+        return      errFailed;
+    }
+
+    try      { ossia::sc::check_argument_type(pyr_remote_port, { "Integer" }); }
+    catch    ( const std::exception &e )
+    {
+        ERROTP      (e, ERR_HDR, "Remote OSCPort argument.");
+        return      errFailed;
+    }
+
+    try      { ossia::sc::check_argument_type(pyr_local_port, { "Integer" }); }
+    catch    ( const std::exception &e )
+    {
+        ERROTP      (e, ERR_HDR, "Local OSCPort argument.");
+        return      errFailed;
+    }
+
+    if (IsTrue(pyr_batched))
+    {
+#ifdef OSSIA_SC_DATAGRAM_SOCKETS
+        auto stats = std::make_shared<protocol_stats>("osc_batched");
+        auto batched_proto = std::make_unique<batched_osc_protocol>(
+                    sc::read_string(pyr_remote_ip),
+                    sc::read_int(pyr_remote_port),
+                    sc::read_int(pyr_local_port),
+                    stats);
+
+        sc::expose(sc::get_device(rcvr), std::move(batched_proto), "osc_batched", stats);
+        return errNone;
+#else
+        std::cout << HDR << WRN_HDR << "batched OSC is not available on this platform, using regular OSC." << std::endl;
+#endif
+    }
+
+    auto osc_proto = std::make_unique<osc_protocol>(
+                sc::read_string(pyr_remote_ip),
+                sc::read_int(pyr_remote_port),
+                sc::read_int(pyr_local_port));
+
+    sc::expose(sc::get_device(rcvr), std::move(osc_proto), "osc");
+
+    return errNone;
+}
+
+int pyr_expose_local(vmglobals *g, int n)
+{
+    // socket paths, or explicit ports for osc on the loopback
+    // (the only option where unix datagram sockets aren't available)
+    pyrslot     *rcvr               = g->sp-2,
+                *pyr_local_path     = g->sp-1,
+                *pyr_remote_path    = g->sp;
+
+    try      { ossia::sc::check_argument_type(pyr_local_path, { "String", "Symbol", "Integer" }); }
+    catch    ( const std::exception &e )
+    {
+        ERROTP      (e, ERR_HDR, "Local socket path or port argument.");
+        return      errFailed;
+    }
+
+    try      { ossia::sc::check_argument_type(pyr_remote_path, { "String", "Symbol", "Integer" }); }
     catch    ( const std::exception &e )
     {
-        ERROTP      (e, ERR_HDR, "Device name argument.");
+        ERROTP      (e, ERR_HDR, "Remote socket path or port argument.");
+        return      errFailed;
+    }
+
+    if (IsInt(pyr_local_path) != IsInt(pyr_remote_path))
+    {
+        std::cout << HDR << ERR_HDR << "exposeLocal takes either two socket paths or two ports." << std::endl;
+        return errFailed;
+    }
+
+    if (IsInt(pyr_local_path))
+    {
+        auto local_port     = sc::read_int(pyr_local_path);
+        auto remote_port    = sc::read_int(pyr_remote_path);
+
+        if (local_port == remote_port)
+        {
+            std::cout << HDR << ERR_HDR << "the local and remote ports must differ." << std::endl;
+            return errFailed;
+        }
+
+#ifdef OSSIA_SC_DATAGRAM_SOCKETS
+        auto stats = std::make_shared<protocol_stats>("local");
+        auto local_proto = std::make_unique<batched_osc_protocol>(
+                    "127.0.0.1", remote_port, local_port, stats);
+
+        sc::expose(sc::get_device(rcvr), std::move(local_proto), "local", stats);
+#else
+        auto osc_proto = std::make_unique<osc_protocol>("127.0.0.1", remote_port, local_port);
+        sc::expose(sc::get_device(rcvr), std::move(osc_proto), "osc");
+#endif
+        return errNone;
+    }
+
+#ifdef OSSIA_SC_DATAGRAM_SOCKETS
+    auto stats = std::make_shared<protocol_stats>("local");
+    auto local_proto = std::make_unique<batched_osc_protocol>(
+                sc::read_string(pyr_local_path),
+                sc::read_string(pyr_remote_path),
+                stats);
+
+    sc::expose(sc::get_device(rcvr), std::move(local_proto), "local", stats);
+    return errNone;
+#else
+    std::cout << HDR << ERR_HDR << "unix sockets are not available on this platform, "
+              << "pass a local and a remote port instead of socket paths." << std::endl;
+    return errFailed;
+#endif
+}
+
+int pyr_device_set_logger(vmglobals *g, int n)
+{
+    auto& mpx = sc::get_multiplex(g->sp);
+
+    /*for(const auto& protocol : mpx.get_protocols())
+    {
+        protocol.set_logger(g_logger);
+    }*/
+
+    return errNone;
+}
+
+int pyr_device_remove_logger(vmglobals *g, int n)
+{
+    return errNone;
+}
+
+net::node_base* reuse_or_remove_child(net::node_base& parent, const std::string& name)
+{
+    // returns the existing child if it is re-created within a transaction or in upsert mode,
+    // otherwise removes it (overwrite) and returns nullptr
+    auto child = parent.find_child(name);
+    if  (!child) return nullptr;
+
+    auto binding = sc::get_binding(parent.get_device());
+    if  (binding && (binding->edit.active() || binding->upsert))
+    {
+        binding->edit.removals.erase(child);
+
+        // in a plain transaction its former children go at commit, unless re-created as well
+        if (!binding->upsert)
+        {
+            for (auto grandchild : child->children_copy())
+                binding->edit.removals.insert(grandchild);
+        }
+
+        return child;
+    }
+
+    parent.remove_child(name);
+    return nullptr;
+}
+
+int pyr_instantiate_node(vmglobals *g, int n)
+{
+    pyrslot  *rcvr       = g->sp-2,
+             *pr_parent  = g->sp-1,
+             *pr_name    = g->sp;
+
+    ossia::net::node_base *parent_node;
+
+    try     { parent_node = ossia::sc::get_node(pr_parent); }
+    catch   ( const ossia::sc::ex_arg_type &e)
+    {
+        ERROTP      (e, ERR_HDR, "Parent Argument. Aborting...");
+        return      errFailed;
+    }
+    catch   ( const ossia::sc::ex_arg_undef &e)
+    {
+        ERROTP      (e, ERR_HDR, "Parent Argument. Trying in single-device mode...");
+        //! TODO : if a single device, automatically create the node on this device
+        return      errFailed;
+    }
+
+    auto name = sc::read_string(pr_name);
+    auto node = reuse_or_remove_child(*parent_node, name);
+
+    if (node && node->get_parameter()) node->remove_parameter();
+    if (!node) node = &sc::create_child(*parent_node, name);
+
+    sc::register_sc_node (rcvr, node);
+
+    return errNone;
+}
+
+ossia::sc::parameter_spec ossia::sc::read_parameter_spec
+(pyrslot *pr_type, pyrslot *pr_domain, pyrslot *pr_default_value,
+ pyrslot *pr_bounding_mode, pyrslot *pr_critical, pyrslot *pr_repetition_filter)
+{
+    parameter_spec spec;
+
+    // TYPE  ------------------------------------------------
+    try     { spec.type = sc::read_type(pr_type); }
+    catch   ( const std::exception &e )
+    {
+        // deduce it from the default value, throws if we can't
+        spec.type = sc::read_type(pr_default_value);
+    }
+
+    spec.critical = IsTrue(pr_critical);
+    if (spec.type == ossia::val_type::IMPULSE) return spec;
+
+    if (spec.type != ossia::val_type::BOOL)
+    {
+        // DOMAIN -----------------------------------------------
+        try     { spec.domain = sc::read_domain(pr_domain, spec.type); }
+        catch   ( const std::exception &e ) {}
+
+        // BOUNDING MODE ---------------------------------------
+        spec.bounding = sc::read_listed_attribute<ossia::bounding_mode>
+                        (pr_bounding_mode, g_bmodemap);
+    }
+
+    // VALUE ------------------------------------------------
+    try     { spec.default_value = sc::read_value(pr_default_value); }
+    catch   ( const std::exception &e ) {}
+
+    // REPETITION FILTER -------------------------------------
+    spec.repetition_filter = static_cast<ossia::repetition_filter>
+                             (IsTrue(pr_repetition_filter));
+
+    return spec;
+}
+
+ossia::net::parameter_base* ossia::sc::apply_parameter_spec
+(net::node_base& node, const parameter_spec& spec)
+{
+    auto parameter = node.create_parameter(spec.type);
+
+    if (spec.type != ossia::val_type::IMPULSE &&
+        spec.type != ossia::val_type::BOOL)
+    {
+        parameter ->  set_bounding(spec.bounding);
+        parameter ->  set_domain(spec.domain);
+    }
+
+    if (spec.unit)  parameter ->  set_unit(spec.unit);
+
+    parameter     ->  set_repetition_filter(spec.repetition_filter);
+    parameter     ->  set_critical(spec.critical);
+    parameter     ->  set_value_quiet(spec.default_value);
+    sc::push_parameter(*parameter);
+
+    return parameter;
+}
+
+ossia::net::parameter_base* ossia::sc::upsert_parameter
+(net::node_base& node, const parameter_spec& spec)
+{
+    auto parameter = node.get_parameter();
+    if  (!parameter) return apply_parameter_spec(node, spec);
+
+    // callbacks and remote subscriptions stay attached to the same parameter,
+    // each setter notifies the network, so only call those that change something
+    bool retyped = parameter->get_value_type() != spec.type;
+    if  (retyped) parameter->set_value_type(spec.type);
+
+    if (spec.type != ossia::val_type::IMPULSE &&
+        spec.type != ossia::val_type::BOOL)
+    {
+        if (parameter->get_bounding() != spec.bounding)     parameter->set_bounding(spec.bounding);
+        if (parameter->get_domain() != spec.domain)         parameter->set_domain(spec.domain);
+    }
+
+    if (parameter->get_repetition_filter() != spec.repetition_filter)
+        parameter->set_repetition_filter(spec.repetition_filter);
+
+    if (parameter->get_critical() != spec.critical)
+        parameter->set_critical(spec.critical);
+
+    if (spec.unit && parameter->get_unit() != spec.unit)
+        parameter->set_unit(spec.unit);
+
+    // in upsert mode the live value survives re-evaluation, unless its type changed
+    auto binding = get_binding(node.get_device());
+    bool keep_value = binding && binding->upsert && !retyped;
+
+    if (!keep_value && parameter->value() != spec.default_value)
+    {
+        parameter->set_value_quiet(spec.default_value);
+        push_parameter(*parameter);
+    }
+
+    return parameter;
+}
+
+int pyr_instantiate_parameter(vmglobals *g, int n)
+{
+    pyrslot
+    *pr_repetition_filter   =   g->sp,
+    *pr_critical            =   g->sp-1,
+    *pr_bounding_mode       =   g->sp-2,
+    *pr_default_value       =   g->sp-3,
+    *pr_domain              =   g->sp-4,
+    *pr_type                =   g->sp-5,
+    *pr_name                =   g->sp-6,
+    *pr_parent              =   g->sp-7,
+    *rcvr                   =   g->sp-8;
+
+    // PARENT  ------------------------------------------------
+    net::node_base  *parent;
+    try             { parent = sc::get_node(pr_parent); }
+    catch           ( const std::exception &e)
+    {
+        ERROTP      (e, ERR_HDR, "Parent argument, aborting...");
+        return      errFailed;
+    }
+
+    // NAME  ------------------------------------------------
+    try     { sc::check_argument_type(pr_name, { "String", "Symbol" }); }
+    catch   ( const std::exception &e )
+    {
+        ERROTP      (e, ERR_HDR, "Name argument.");
+        return      errFailed;
+    }
+
+    auto name = sc::read_string(pr_name);
+
+    // ATTRIBUTES  ------------------------------------------
+    parameter_spec spec;
+    try     { spec = sc::read_parameter_spec(pr_type, pr_domain, pr_default_value,
+                                             pr_bounding_mode, pr_critical, pr_repetition_filter); }
+    catch   ( const std::exception &e )
+    {
+        ERROTP  (e, ERR_HDR, "Type argument. Could not deduce parameter type.");
+        return  errFailed;
+    }
+
+    // if node already exist, don't increment, overwrite
+    // (within a transaction or in upsert mode, it is updated in place)
+    auto node = reuse_or_remove_child(*parent, name);
+
+    // SET ---------------------------------------------------
+    if (!node) node = &sc::create_child(*parent, name);
+    sc::upsert_parameter(*node, spec);
+
+    // UPDATE RECEIVER NODE ID  ---------------------------
+    ossia::sc::register_sc_node(rcvr, node);
+
+    // RETURN ---------------------------------------------
+    return errNone;
+}
+
+std::string format_indexed_name(const std::string& pattern, int index)
+{
+    // every '%' is replaced by the index, which is appended if there is none
+    auto index_str = std::to_string(index);
+    if  (pattern.find('%') == std::string::npos) return pattern + index_str;
+
+    std::string name;
+    for (auto c : pattern)
+    {
+        if (c == '%')   name += index_str;
+        else            name += c;
+    }
+
+    return name;
+}
+
+int pyr_instantiate_parameter_array(vmglobals *g, int n)
+{
+    // returns an array of handles, wrapped in OSSIA_Parameters on the sc side;
+    // nodes are still announced one by one: libossia's servers listen to the
+    // device signals directly, which give the binding no way to defer them
+    pyrslot
+    *pr_repetition_filter   =   g->sp,
+    *pr_critical            =   g->sp-1,
+    *pr_bounding_mode       =   g->sp-2,
+    *pr_default_value       =   g->sp-3,
+    *pr_domain              =   g->sp-4,
+    *pr_type                =   g->sp-5,
+    *pr_name                =   g->sp-6,
+    *pr_parent              =   g->sp-7,
+    *pr_size                =   g->sp-8,
+    *rcvr                   =   g->sp-9;
+
+    net::node_base *parent;
+    std::string pattern;
+    int size;
+
+    try
+    {
+        parent  = sc::get_node(pr_parent);
+        pattern = sc::read_string(pr_name);
+        size    = sc::read_int(pr_size);
+    }
+    catch   ( const std::exception &e )
+    {
+        ERROTP      (e, ERR_HDR, "Size, parent or name argument.");
+        return      errFailed;
+    }
+
+    // parsed once for the whole array
+    parameter_spec spec;
+    try     { spec = sc::read_parameter_spec(pr_type, pr_domain, pr_default_value,
+                                             pr_bounding_mode, pr_critical, pr_repetition_filter); }
+    catch   ( const std::exception &e )
+    {
+        ERROTP  (e, ERR_HDR, "Type argument. Could not deduce parameter type.");
+        return  errFailed;
+    }
+
+    auto existing = parent->children_names();
+    std::unordered_set<std::string> existing_names(existing.begin(), existing.end());
+
+    std::vector<int> handles;
+    handles.reserve(std::max(size, 0));
+
+    for (int i = 0; i < size; ++i)
+    {
+        auto name = format_indexed_name(pattern, i);
+
+        // overwrite, as the single parameter constructor does
+        net::node_base* node = nullptr;
+        if (existing_names.count(name)) node = reuse_or_remove_child(*parent, name);
+
+        if (!node) node = &sc::create_child(*parent, name);
+
+        sc::upsert_parameter(*node, spec);
+        handles.push_back(g_handles.insert(*node));
+    }
+
+    auto array = newPyrArray(g->gc, handles.size(), 0, true);
+    SetObject(rcvr, array);
+
+    for (auto handle : handles)
+    {
+        SetInt(array->slots+array->size, handle);
+        array->size++;
+    }
+
+    return errNone;
+}
+
+
+ossia::sc::subtree_template ossia::sc::read_template(pyrslot *s)
+{
+    check_argument_type(s, { "Array" });
+
+    subtree_template tmpl;
+    auto entries = slotRawObject(s);
+
+    for (int i = 0; i < entries->size; ++i)
+    {
+        auto entry = entries->slots+i;
+        check_argument_type(entry, { "Array" });
+
+        auto fields = slotRawObject(entry)->slots;
+        auto size   = slotRawObject(entry)->size;
+        subtree_template::entry e { sc::read_string(fields) };
+
+        if (size >= 7)
+        {
+            e.spec = sc::read_parameter_spec(fields+1, fields+2, fields+3,
+                                             fields+4, fields+5, fields+6);
+
+            if (size >= 8 && !IsNil(fields+7))
+                e.spec->unit = ossia::parse_pretty_unit(sc::read_string(fields+7));
+        }
+
+        tmpl.entries.push_back(std::move(e));
+    }
+
+    return tmpl;
+}
+
+int pyr_template_instantiate(vmglobals *g, int n)
+{
+    pyrslot *rcvr       = g->sp-1,
+            *pr_entries = g->sp;
+
+    std::unique_ptr<subtree_template> tmpl;
+    try     { tmpl = std::make_unique<subtree_template>(sc::read_template(pr_entries)); }
+    catch   ( const std::exception &e )
+    {
+        ERROTP      (e, ERR_HDR, "Template entries.");
+        return      errFailed;
+    }
+
+    auto id = ++g_template_count;
+    g_templates[id] = std::move(tmpl);
+
+    SetInt(slotRawObject(rcvr)->slots+1, id);
+    return errNone;
+}
+
+int pyr_template_free(vmglobals *g, int n)
+{
+    auto id = slotRawObject(g->sp)->slots+1;
+    if  (IsInt(id)) g_templates.erase(slotRawInt(id));
+    SetNil(id);
+    return errNone;
+}
+
+void apply_template(net::node_base& root, const subtree_template& tmpl, bool fresh)
+{
+    for (const auto& entry : tmpl.entries)
+    {
+        // a fresh root has no children yet, no need to look them up
+        net::node_base* node = fresh ? nullptr : sc::find_node(root, entry.path);
+        if (!node) node = &sc::create_child(root, entry.path);
+
+        if (entry.spec) sc::upsert_parameter(*node, *entry.spec);
+    }
+}
+
+int pyr_template_apply(vmglobals *g, int n)
+{
+    // returns the handles of the instances' root nodes, wrapped in OSSIA_Nodes on the sc side
+    pyrslot *rcvr       = g->sp-3,
+            *pr_parents = g->sp-2,
+            *pr_name    = g->sp-1,
+            *pr_count   = g->sp;
+
+    auto id = slotRawObject(rcvr)->slots+1;
+    auto it = IsInt(id) ? g_templates.find(slotRawInt(id)) : g_templates.end();
+    if  (it == g_templates.end())
+    {
+        std::cout << HDR << ERR_HDR << "template was freed." << std::endl;
+        return errFailed;
+    }
+
+    std::vector<net::node_base*> parents;
+    std::string pattern;
+    int count;
+
+    try
+    {
+        parents = sc::read_vector<net::node_base*>(pr_parents, sc::get_node);
+        count   = IsNil(pr_name) ? 1 : sc::read_int(pr_count);
+        if (!IsNil(pr_name)) pattern = sc::read_string(pr_name);
+    }
+    catch   ( const std::exception &e )
+    {
+        ERROTP      (e, ERR_HDR, "Parents, name or count argument.");
+        return      errFailed;
+    }
+
+    auto& tmpl = *it->second;
+    std::vector<int> handles;
+    handles.reserve(parents.size() * std::max(count, 0));
+
+    for (auto parent : parents)
+    {
+        if (pattern.empty())
+        {
+            // applied directly under the parent
+            apply_template(*parent, tmpl, false);
+            handles.push_back(g_handles.insert(*parent));
+            continue;
+        }
+
+        for (int i = 0; i < count; ++i)
+        {
+            auto name = count > 1 || pattern.find('%') != std::string::npos
+                      ? format_indexed_name(pattern, i)
+                      : pattern;
+
+            // overwrite, as the node constructor does
+            auto root  = reuse_or_remove_child(*parent, name);
+            bool fresh = !root;
+            if  (fresh) root = &sc::create_child(*parent, name);
+
+            apply_template(*root, tmpl, fresh);
+            handles.push_back(g_handles.insert(*root));
+        }
+    }
+
+    auto array = newPyrArray(g->gc, handles.size(), 0, true);
+    SetObject(rcvr, array);
+
+    for (auto handle : handles)
+    {
+        SetInt(array->slots+array->size, handle);
+        array->size++;
+    }
+
+    return errNone;
+}
+
+int pyr_node_free(vmglobals* g, int n)
+{
+    auto node = sc::get_node(g->sp);
+    auto binding = sc::get_binding(node->get_device());
+
+    if  (binding && binding->edit.active())
+         binding->edit.removals.insert(node);
+    else node->get_parent()->remove_child(*node);
+
+    SetNil(g->sp);
+    return errNone;
+}
+
+int pyr_node_get_mirror(vmglobals *g, int n)
+{
+    net::node_base *origin;
+    try     { origin = sc::get_node(g->sp-1); }
+    catch   ( const std::exception &e )
+    {
+        ERROTP      (e, ERR_HDR, "Device argument.");
+        return      errFailed;
+    }
+
+    auto node = sc::find_node(*origin, sc::read_string(g->sp));
+    if  (!node)
+    {
+        ERROTP      (NODE_NOT_FOUND, ERR_HDR, "Mirror address.");
         return      errFailed;
     }
 
-    auto device_name        = sc::read_string(g->sp);
-    auto mpx_proto_ptr      = std::make_unique<multiplex_protocol>();
-    auto device             = new net::generic_device(std::move(mpx_proto_ptr), device_name);
-
-    sc::register_sc_node    (g->sp-1, dynamic_cast<net::node_base*>(device));
-
-    return      errNone;
+    sc::register_sc_node(g->sp-2, node);
+    return errNone;
+}
+
+int pyr_node_get_name(vmglobals *g, int n)
+{
+    sc::write_string(g, g->sp, sc::get_node(g->sp)->get_name());
+    return errNone;
+}
+
+int pyr_node_get_full_path(vmglobals *g, int n)
+{
+    auto node           = sc::get_node(g->sp);
+    std::string path    = ossia::net::osc_parameter_string_with_device(*node);
+    sc::write_string    (g, g->sp, path.c_str());
+    return              errNone;
+}
+
+int pyr_node_get_children_names(vmglobals *g, int n)
+{
+    auto node = sc::get_node(g->sp);
+    sc::expand(*node);
+    std::vector<std::string> children_names = node->children_names();
+    sc::write_array<std::vector<std::string>,std::string>(g, g->sp, children_names, sc::write_string);
+
+    return errNone;
+}
+
+void make_node_sheet(net::node_base& node, std::vector<ossia::value>& destination,
+                     bool with_attributes = false, bool parameters_only = false)
+{
+    std::vector<ossia::value>  sheet;
+    auto parameter = node.get_parameter();
+
+    if (parameters_only && !parameter) return;
+
+    auto fullpath = ossia::net::osc_parameter_string(node);
+
+    sheet.push_back(fullpath);
+    sheet.push_back(g_handles.insert(node));
+
+    if  ( parameter ) sheet.push_back(parameter->value());
+
+    if( with_attributes )
+    {
+        auto type   = net::get_value_type(node).value_or(ossia::val_type::NONE);
+        auto amode  = net::get_access_mode(node);
+        auto bmode  = net::get_bounding_mode(node);
+
+        sheet.push_back(format_listed_attribute<ossia::val_type>(type, g_typemap));
+        sheet.push_back(format_listed_attribute<access_mode>(*amode, g_accessmap));
+        sheet.push_back(format_listed_attribute<bounding_mode>(*bmode, g_bmodemap));
+        sheet.push_back(net::get_description(node).value_or("no description"));
+        //res_c.push_back(net::get_tags(*child).value_or("nil"));
+        sheet.push_back(net::get_critical(node));
+        sheet.push_back((bool)net::get_repetition_filter(node));
+    }
+
+    destination.push_back(sheet);
 }
 
-int pyr_expose_oscquery_server(vmglobals *g, int n)
+bool ossia::sc::glob_match(const char* pattern, const char* path) noexcept
 {
-    pyrslot  *rcvr           = g->sp-2,
-             *pr_osc_port    = g->sp-1,
-             *pr_ws_port     = g->sp;
-
-    try      { ossia::sc::check_argument_type(pr_osc_port, { "Integer" }); }
-    catch    ( const std::exception &e )
+    for ( ; *pattern; ++pattern, ++path)
     {
-        ERROTP      (e, ERR_HDR, "OSC Port argument.");
-        return      errFailed;
-    }
+        // a trailing "/**" also matches the level it hangs from: "/light/**" matches "/light"
+        if (!*path && std::strcmp(pattern, "/**") == 0) return true;
 
-    try      { ossia::sc::check_argument_type(pr_ws_port, { "Integer" }); }
-    catch    ( const std::exception &e )
-    {
-        ERROTP      (e, ERR_HDR, "WS Port argument.");
-        return      errFailed;
-    }
+        if (*pattern == '*')
+        {
+            bool any_segment = pattern[1] == '*';
+            pattern += any_segment ? 2 : 1;
+
+            for ( ; ; ++path)
+            {
+                if (glob_match(pattern, path))          return true;
+                if (!*path)                             return false;
+                if (!any_segment && *path == '/')       return false;
+            }
+        }
 
-    auto oscq_protocol = std::make_unique<oscquery_server_protocol>
-                         (sc::read_int(pr_osc_port), sc::read_int(pr_ws_port));    
+        if (!*path)                                     return false;
+        if (*pattern == '?' && *path != '/')            continue;
+        if (*pattern != *path)                          return false;
+    }
 
-    auto target_device  = dynamic_cast<net::generic_device*>(sc::get_node(rcvr));
-    auto proto_mpx      = dynamic_cast<net::multiplex_protocol*>(&target_device->get_protocol());
+    return !*path;
+}
 
-    proto_mpx           ->expose_to(std::move(oscq_protocol));
+bool ossia::sc::explore_filter::empty() const noexcept
+{
+    return tags.empty() && !type && !access && unit.empty() && !critical && path.empty();
+}
 
-    return               errNone;
+bool ossia::sc::explore_filter::operator==(const explore_filter& other) const noexcept
+{
+    return tags == other.tags && type == other.type && access == other.access
+        && unit == other.unit && critical == other.critical && path == other.path;
 }
 
-int pyr_expose_oscquery_mirror(vmglobals *g, int n)
+bool ossia::sc::explore_filter::matches(net::node_base& node) const
 {
-    pyrslot     *rcvr       = g->sp-1,
-                *pyr_host   = g->sp;
+    // cheapest predicates first, the path is only built if there is a glob
+    auto parameter = node.get_parameter();
 
-    try      { ossia::sc::check_argument_type(pyr_host, { "String", "Symbol" }); }
-    catch    ( const std::exception &e )
+    if (type || access || critical || !unit.empty())
     {
-        ERROTP      (e, ERR_HDR, "Host Address argument.");
-        return      errFailed;
-    }
+        if (!parameter) return false;
+        if (type        && parameter->get_value_type() != *type)    return false;
+        if (access      && parameter->get_access() != *access)      return false;
+        if (critical    && parameter->get_critical() != *critical)  return false;
 
-    auto mirror_proto_ptr = std::make_unique<oscquery_mirror_protocol>
-                           (sc::read_string(pyr_host));
+        if (!unit.empty())
+        {
+            // "gain" matches the whole family, "gain.db" only that unit
+            auto text = get_pretty_unit_text(parameter->get_unit());
+            if (unit.find('.') == std::string::npos)
+                 text = text.substr(0, text.find('.'));
+            if (text != unit) return false;
+        }
+    }
 
-    auto mirror         = mirror_proto_ptr.get();
+    if (!tags.empty())
+    {
+        auto node_tags = net::get_tags(node);
+        if  (!node_tags) return false;
 
-    auto target_device  = dynamic_cast<net::generic_device*>(sc::get_node(rcvr));
-    auto multiplex      = dynamic_cast<net::multiplex_protocol*>(&target_device->get_protocol());
+        for (const auto& tag : tags)
+        {
+            if (std::find(node_tags->begin(), node_tags->end(), tag) == node_tags->end())
+                return false;
+        }
+    }
 
-    multiplex           ->expose_to(std::move(mirror_proto_ptr));
-    mirror              ->update(*target_device);
+    if (!path.empty())
+        return glob_match(path.c_str(), net::osc_parameter_string(node).c_str());
 
-    return errNone;
+    return true;
 }
 
-int pyr_expose_minuit(vmglobals *g, int n)
+ossia::sc::explore_cursor::explore_cursor(net::node_base& root, int max_depth,
+                                          bool with_attributes, bool parameters_only,
+                                          explore_filter filter) :
+    m_device(root.get_device()),
+    m_max_depth(max_depth),
+    m_with_attributes(with_attributes),
+    m_parameters_only(parameters_only),
+    m_filter(std::move(filter))
 {
-    pyrslot     *rcvr               = g->sp-3,
-                *pyr_remote_ip      = g->sp-2,
-                *pyr_remote_port    = g->sp-1,
-                *pyr_local_port     = g->sp;
-
-    try      { ossia::sc::check_argument_type(pyr_remote_ip, { "String", "Symbol" }); }
-    catch    ( const std::exception &e )
+    // lazy mirrors are materialised as the walk goes
+    if (max_depth != 0)
     {
-        ERROTP      (e, ERR_HDR, "Remote IP argument.");
-        return      errFailed;
+        sc::expand(root);
+        m_stack.push_back({ &root, root.children_copy(), 0, 1 });
     }
+    m_device.on_node_removing.connect<&explore_cursor::on_node_removing>(this);
+}
 
-    try      { ossia::sc::check_argument_type(pyr_remote_port, { "Integer" }); }
-    catch    ( const std::exception &e )
-    {
-        ERROTP      (e, ERR_HDR, "Remote OSCPort argument.");
-        return      errFailed;
-    }
+ossia::sc::explore_cursor::~explore_cursor()
+{
+    m_device.on_node_removing.disconnect<&explore_cursor::on_node_removing>(this);
+}
 
-    try      { ossia::sc::check_argument_type(pyr_local_port, { "Integer" }); }
-    catch    ( const std::exception &e )
+std::size_t ossia::sc::explore_cursor::next(std::vector<ossia::value>* destination, std::size_t limit,
+                                            std::size_t max_visits)
+{
+    // walks until limit matching nodes are found, or max_visits nodes were visited
+    // (so that a selective filter can't hold the interpreter for a whole tree),
+    // sheets are written if destination is set
+    std::size_t count = 0, visits = 0;
+
+    while (!m_stack.empty() && count < limit && visits < max_visits)
     {
-        ERROTP      (e, ERR_HDR, "Local OSCPort argument.");
-        return      errFailed;
+        auto& top = m_stack.back();
+        if (top.index == top.children.size())
+        {
+            m_stack.pop_back();
+            continue;
+        }
+
+        auto child  = top.children[top.index++];
+        auto depth  = top.depth;
+        ++visits;
+
+        if ((!m_parameters_only || child->get_parameter()) && m_filter.matches(*child))
+        {
+            if (destination) make_node_sheet(*child, *destination, m_with_attributes, m_parameters_only);
+            ++count;
+        }
+
+        if (m_max_depth < 0 || depth < m_max_depth)
+        {
+            sc::expand(*child);
+            m_stack.push_back({ child, child->children_copy(), 0, depth + 1 });
+        }
     }
 
-    auto target_device = dynamic_cast<net::generic_device*>(sc::get_node(rcvr));
-    auto device_name = target_device->get_name();
+    // drop exhausted frames, so that done() is accurate
+    while (!m_stack.empty() && m_stack.back().index == m_stack.back().children.size())
+        m_stack.pop_back();
 
-    auto minuit_proto = std::make_unique<minuit_protocol>(
-                        device_name,
-                        sc::read_string(pyr_remote_ip),
-                        sc::read_int(pyr_remote_port),
-                        sc::read_int(pyr_local_port));
+    return count;
+}
 
-    auto multiplex = dynamic_cast<net::multiplex_protocol*>(&target_device->get_protocol());
-    multiplex->expose_to(std::move(minuit_proto));
+bool ossia::sc::explore_cursor::done() const noexcept
+{
+    return m_stack.empty();
+}
 
-    return errNone;
+ossia::net::device_base& ossia::sc::explore_cursor::device() const noexcept
+{
+    return m_device;
 }
 
-int pyr_expose_osc(vmglobals *g, int n)
+void ossia::sc::explore_cursor::on_node_removing(const net::node_base& node)
 {
-    pyrslot     *rcvr               = g->sp-3,
-                *pyr_remote_ip      = g->sp-2,
-                *pyr_remote_port    = g->sp-1,
-                *pyr_local_port     = g->sp;
+    if (m_stack.empty()) return;
 
-    try      { ossia::sc::check_argument_type(pyr_remote_ip, { "String", "Symbol" }); }
-    catch    ( const std::exception &e )
+    // the root going away (directly or with an ancestor) ends the walk
+    for (auto parent = m_stack.front().parent; parent; parent = parent->get_parent())
     {
-        ERROTP      (e, ERR_HDR, "Remote IP argument.");
-        return      errFailed;
+        if (parent == &node)
+        {
+            m_stack.clear();
+            return;
+        }
     }
 
-    try      { ossia::sc::check_argument_type(pyr_remote_port, { "Integer" }); }
-    catch    ( const std::exception &e )
+    for (std::size_t i = 0; i < m_stack.size(); ++i)
     {
-        ERROTP      (e, ERR_HDR, "Remote OSCPort argument.");
-        return      errFailed;
-    }
+        auto& frame = m_stack[i];
+        if (frame.parent == &node)
+        {
+            // we're inside the removed subtree, resume from its parent
+            m_stack.resize(i);
+            return;
+        }
 
-    try      { ossia::sc::check_argument_type(pyr_local_port, { "Integer" }); }
-    catch    ( const std::exception &e )
-    {
-        ERROTP      (e, ERR_HDR, "Local OSCPort argument.");
-        return      errFailed;
+        auto pending = std::find(frame.children.begin() + frame.index, frame.children.end(), &node);
+        if  (pending != frame.children.end()) frame.children.erase(pending);
     }
-
-    auto target_device = dynamic_cast<net::generic_device*>(sc::get_node(rcvr));
-    auto multiplex = dynamic_cast<net::multiplex_protocol*>(&target_device->get_protocol());
-
-    auto osc_proto = std::make_unique<osc_protocol>(
-                sc::read_string(pyr_remote_ip),
-                sc::read_int(pyr_remote_port),
-                sc::read_int(pyr_local_port));
-
-    multiplex->expose_to(std::move(osc_proto));
-
-    return errNone;
 }
 
-int pyr_device_set_logger(vmglobals *g, int n)
+struct explore_page
 {
-    auto device = dynamic_cast<net::generic_device*>(ossia::sc::get_node(g->sp));
-    auto mpx = dynamic_cast<net::multiplex_protocol*>(&device->get_protocol());
-
-    /*for(const auto& protocol : mpx->get_protocols())
+    const net::node_base*           root;
+    int                             depth;
+    bool                            with_attributes;
+    bool                            parameters_only;
+    explore_filter                  filter;
+    std::size_t                     position;
+    std::unique_ptr<explore_cursor> cursor;
+};
+
+// the last explore() call's cursor, resumed when the next call asks for the following page
+std::unique_ptr<explore_page> g_explore_page;
+
+void forget_cursors(const net::device_base& device)
+{
+    for (auto it = g_cursors.begin(); it != g_cursors.end(); )
     {
-        protocol.set_logger(g_logger);
-    }*/
+        if (&it->second->device() == &device) it = g_cursors.erase(it);
+        else ++it;
+    }
 
-    return errNone;
+    if (g_explore_page && &g_explore_page->cursor->device() == &device)
+        g_explore_page.reset();
 }
 
-int pyr_device_remove_logger(vmglobals *g, int n)
+int read_optional_int(pyrslot *s, int default_value)
 {
-    return errNone;
+    if (IsNil(s)) return default_value;
+    return sc::read_int(s);
 }
 
-int pyr_instantiate_node(vmglobals *g, int n)
+int pyr_node_get_sheet(vmglobals *g, int n)
 {
-    pyrslot  *rcvr       = g->sp-2,
-             *pr_parent  = g->sp-1,
-             *pr_name    = g->sp;
+    std::vector<ossia::value> sheet;
+    make_node_sheet(*sc::get_node(g->sp), sheet, true, false);
 
-    ossia::net::node_base *parent_node;
+    sc::write_value(g, g->sp, sheet);
+    return errNone;
+}
 
-    try     { parent_node = ossia::sc::get_node(pr_parent); }
-    catch   ( const ossia::sc::ex_arg_type &e)
+int pyr_node_explore(vmglobals *g, int n)
+{
+    pyrslot *rcvr               = g->sp-6,
+            *pr_with_attributes = g->sp-5,
+            *pr_parameters_only = g->sp-4,
+            *pr_depth           = g->sp-3,
+            *pr_offset          = g->sp-2,
+            *pr_limit           = g->sp-1,
+            *pr_filter          = g->sp;
+
+    int depth, offset, limit;
+    try
     {
-        ERROTP      (e, ERR_HDR, "Parent Argument. Aborting...");
+        depth   = read_optional_int(pr_depth, -1);
+        offset  = read_optional_int(pr_offset, 0);
+        limit   = read_optional_int(pr_limit, -1);
+    }
+    catch   ( const std::exception &e )
+    {
+        ERROTP      (e, ERR_HDR, "Depth, offset and limit arguments should be Integers or nil.");
         return      errFailed;
     }
-    catch   ( const ossia::sc::ex_arg_undef &e)
+
+    explore_filter filter;
+    try     { filter = sc::read_filter(pr_filter); }
+    catch   ( const std::exception &e )
     {
-        ERROTP      (e, ERR_HDR, "Parent Argument. Trying in single-device mode...");
-        //! TODO : if a single device, automatically create the node on this device
+        ERROTP      (e, ERR_HDR, "Filter argument.");
         return      errFailed;
     }
 
-    auto name = sc::read_string(pr_name);
-    if ( parent_node->find_child(name) )
+    auto node               = sc::get_node(rcvr);
+    bool with_attributes    = IsTrue(pr_with_attributes);
+    bool parameters_only    = IsTrue(pr_parameters_only);
+    offset                  = std::max(offset, 0);
+
+    // paging through a subtree resumes the previous call's walk instead of
+    // skipping offset nodes again, a finished or interrupted walk is started over
+    auto& page = g_explore_page;
+    if (!page || page->root != node || page->depth != depth
+              || page->with_attributes != with_attributes || page->parameters_only != parameters_only
+              || !(page->filter == filter) || page->cursor->done()
+              || page->position != static_cast<std::size_t>(offset))
     {
-        parent_node->remove_child(name);
+        page.reset(new explore_page{ node, depth, with_attributes, parameters_only, filter, 0,
+                   std::make_unique<explore_cursor>(*node, depth, with_attributes,
+                                                    parameters_only, filter) });
+
+        if (offset > 0) page->position = page->cursor->next(nullptr, offset);
     }
 
-    auto node = &net::find_or_create_node(*parent_node, name);
-    sc::register_sc_node (rcvr, node);
+    std::vector<ossia::value> tree;
+    page->position += page->cursor->next(&tree, limit < 0 ? SIZE_MAX : static_cast<std::size_t>(limit));
+
+    // a whole-tree walk has no following page
+    if (limit < 0) page.reset();
+
+    sc::write_value(g, rcvr, tree);
 
     return errNone;
 }
 
-int pyr_instantiate_parameter(vmglobals *g, int n)
+int pyr_explore_cursor_instantiate(vmglobals *g, int n)
 {
-    pyrslot
-    *pr_repetition_filter   =   g->sp,
-    *pr_critical            =   g->sp-1,
-    *pr_bounding_mode       =   g->sp-2,
-    *pr_default_value       =   g->sp-3,
-    *pr_domain              =   g->sp-4,
-    *pr_type                =   g->sp-5,
-    *pr_name                =   g->sp-6,
-    *pr_parent              =   g->sp-7,
-    *rcvr                   =   g->sp-8;
+    pyrslot *rcvr               = g->sp-5,
+            *pr_node            = g->sp-4,
+            *pr_with_attributes = g->sp-3,
+            *pr_parameters_only = g->sp-2,
+            *pr_depth           = g->sp-1,
+            *pr_filter          = g->sp;
 
-    ossia::val_type             type;
-    ossia::bounding_mode        bounding_mode;
-    ossia::domain               domain;
-    ossia::repetition_filter    repetition_filter;
-    ossia::value                defvalue;
+    net::node_base *node;
+    explore_filter filter;
+    int depth;
 
-    // PARENT  ------------------------------------------------
-    net::node_base  *parent;
-    try             { parent = sc::get_node(pr_parent); }
-    catch           ( const std::exception e)
+    try
     {
-        ERROTP      (e, ERR_HDR, "Parent argument, aborting...");
-        return      errFailed;
+        node    = sc::get_node(pr_node);
+        depth   = read_optional_int(pr_depth, -1);
+        filter  = sc::read_filter(pr_filter);
     }
-
-    // NAME  ------------------------------------------------
-    try     { sc::check_argument_type(pr_name, { "String", "Symbol" }); }
     catch   ( const std::exception &e )
     {
-        ERROTP      (e, ERR_HDR, "Name argument.");
+        ERROTP      (e, ERR_HDR, "Node, depth or filter argument.");
         return      errFailed;
     }
 
-    auto name = sc::read_string(pr_name);
+    auto id = ++g_cursor_count;
+    g_cursors[id] = std::make_unique<explore_cursor>
+                    (*node, depth, IsTrue(pr_with_attributes), IsTrue(pr_parameters_only), std::move(filter));
 
-    // if node already exist, don't increment, overwrite
-    if ( parent->find_child(name) )
+    SetInt(slotRawObject(rcvr)->slots, id);
+    return errNone;
+}
+
+constexpr std::size_t CURSOR_MAX_VISITS = 4096;
+
+int pyr_explore_cursor_next(vmglobals *g, int n)
+{
+    // returns the next chunk of node sheets, or nil once the walk is over
+    pyrslot *rcvr       = g->sp-1,
+            *pr_limit   = g->sp;
+
+    auto id = slotRawObject(rcvr)->slots;
+    auto it = IsInt(id) ? g_cursors.find(slotRawInt(id)) : g_cursors.end();
+    if  (it == g_cursors.end())
     {
-        parent->remove_child(name);
+        SetNil(rcvr);
+        return errNone;
     }
 
-    // TYPE  ------------------------------------------------
-    try     { type = sc::read_type(pr_type); }
+    int limit;
+    try     { limit = sc::read_int(pr_limit); }
     catch   ( const std::exception &e )
     {
-        try     { type = sc::read_type(pr_default_value); }
-        catch   ( const std::exception &exc )
-        {
-            ERROTP  (e, ERR_HDR, "Type argument. Could not deduce parameter type.");
-            return  errFailed;
-        }
+        ERROTP      (e, ERR_HDR, "Limit argument.");
+        return      errFailed;
     }
 
-    if          (type == ossia::val_type::IMPULSE)  goto critical;
-    else if     (type == ossia::val_type::BOOL)     goto value;
-
-    // DOMAIN -----------------------------------------------
-
-    try     { domain = sc::read_domain(pr_domain, type); }
-    catch   ( const std::exception &e ) {}
-
-    // BOUNDING MODE ---------------------------------------
-    bounding_mode = sc::read_listed_attribute<ossia::bounding_mode>
-                    (pr_bounding_mode, g_bmodemap);
-
-    value: //------------------------------------------------
-    try     { defvalue = sc::read_value(pr_default_value); }
-    catch   ( const std::exception &e ) {}
-
-    // REPETITION FILTER -------------------------------------
-    repetition_filter   =   static_cast<ossia::repetition_filter>
-                            (IsTrue(pr_repetition_filter));
-
-    critical: // ---------------------------------------------
-    bool critical       =   IsTrue(pr_critical);
-
-    // SET ---------------------------------------------------
-    auto node = &net::find_or_create_node(*parent, name);
-    auto parameter = node->create_parameter(type);
-
-    if (type ==  ossia::val_type::IMPULSE ||
-        type ==  ossia::val_type::BOOL ) goto common;
+    // a chunk visits a bounded number of nodes, and may come back empty
+    // when a selective filter didn't match any of them
+    std::vector<ossia::value> chunk;
+    auto chunk_size = static_cast<std::size_t>(std::max(limit, 1));
+    it->second->next(&chunk, chunk_size, std::max(chunk_size, CURSOR_MAX_VISITS));
 
-    parameter         ->  set_bounding(bounding_mode);
-    parameter         ->  set_domain(domain);
+    bool done = it->second->done();
+    if  (done) g_cursors.erase(it);
 
-    common:
-    parameter         ->  set_repetition_filter(repetition_filter);
-    parameter         ->  set_critical(critical);
-    parameter         ->  push_value(defvalue);
+    if (chunk.empty() && done) SetNil(rcvr);
+    else sc::write_value(g, rcvr, chunk);
 
-    // UPDATE RECEIVER NODE ID  ---------------------------
-    ossia::sc::register_sc_node(rcvr, node);
+    return errNone;
+}
 
-    // RETURN ---------------------------------------------
+int pyr_explore_cursor_free(vmglobals *g, int n)
+{
+    auto id = slotRawObject(g->sp)->slots;
+    if  (IsInt(id)) g_cursors.erase(slotRawInt(id));
     return errNone;
 }
 
+void collect_nodes(net::node_base& node, std::vector<net::node_base*>& nodes,
+                   bool parameters_only = false, const explore_filter* filter = nullptr)
+{
+    for (const auto& child : node.children_copy())
+    {
+        if ((!parameters_only || child->get_parameter()) && (!filter || filter->matches(*child)))
+            nodes.push_back(child);
 
-int pyr_node_free(vmglobals* g, int n)
+        collect_nodes(*child, nodes, parameters_only, filter);
+    }
+}
+
+void write_node_path(vmglobals *g, pyrslot *target, net::node_base* const& node) noexcept
 {
-    auto node = sc::get_node(g->sp);
-    node->get_parent()->remove_child(*node);
-    SetNil(g->sp);
-    return errNone;
+    sc::write_symbol(g, target, ossia::net::osc_parameter_string(*node));
 }
 
-int pyr_node_get_mirror(vmglobals *g, int n)
+void write_node_handle(vmglobals *g, pyrslot *target, net::node_base* const& node)
 {
-    auto node = ossia::net::find_node(*sc::get_node(g->sp-1), sc::read_string(g->sp));
-    if  (!node)  throw NODE_NOT_FOUND;
-    sc::register_sc_node(g->sp-2, node);
-    return errNone;
+    SetInt(target, g_handles.insert(*node));
 }
 
-int pyr_node_get_name(vmglobals *g, int n)
+void write_node_value(vmglobals *g, pyrslot *target, net::node_base* const& node) noexcept
 {
-    sc::write_string(g, g->sp, sc::get_node(g->sp)->get_name());
-    return errNone;
+    auto parameter = node->get_parameter();
+    if (parameter) sc::write_value(g, target, parameter->value());
+    else SetNil(target);
 }
 
-int pyr_node_get_full_path(vmglobals *g, int n)
+void write_node_type(vmglobals *g, pyrslot *target, net::node_base* const& node) noexcept
 {
-    auto node           = sc::get_node(g->sp);
-    std::string path    = ossia::net::osc_parameter_string_with_device(*node);
-    sc::write_string    (g, g->sp, path.c_str());
-    return              errNone;
+    auto parameter = node->get_parameter();
+    if (parameter) SetInt(target, static_cast<int>(parameter->get_value_type()));
+    else SetInt(target, static_cast<int>(ossia::val_type::NONE));
 }
 
-int pyr_node_get_children_names(vmglobals *g, int n)
+int pyr_node_explore_columns(vmglobals *g, int n)
 {
-    auto node = sc::get_node(g->sp);
-    std::vector<std::string> children_names = node->children_names();
-    sc::write_array<std::vector<std::string>,std::string>(g, g->sp, children_names, sc::write_string);
+    // returns [paths, handles, values, types], unselected columns are nil
+    pyrslot *rcvr               = g->sp-3,
+            *pr_parameters_only = g->sp-2,
+            *pr_columns         = g->sp-1,
+            *pr_filter          = g->sp;
+
+    uint8_t columns;
+    try     { columns = sc::read_columns(pr_columns); }
+    catch   ( const std::exception &e )
+    {
+        ERROTP      (e, ERR_HDR, "Columns argument, expected an array of 'path', 'handle', 'value' or 'type'.");
+        return      errFailed;
+    }
+
+    explore_filter filter;
+    try     { filter = sc::read_filter(pr_filter); }
+    catch   ( const std::exception &e )
+    {
+        ERROTP      (e, ERR_HDR, "Filter argument.");
+        return      errFailed;
+    }
+
+    auto node = sc::get_node(rcvr);
+    std::vector<net::node_base*> nodes;
+    sc::expand(*node, -1);
+    collect_nodes(*node, nodes, IsTrue(pr_parameters_only), filter.empty() ? nullptr : &filter);
+
+    using writer = void (*)(vmglobals*, pyrslot*, net::node_base* const&);
+    const std::pair<explore_column, writer> writers[] =
+    {
+        { COL_PATH,     write_node_path },
+        { COL_HANDLE,   write_node_handle },
+        { COL_VALUE,    write_node_value },
+        { COL_TYPE,     write_node_type }
+    };
+
+    auto table = newPyrArray(g->gc, 4, 0, true);
+    SetObject(rcvr, table);
+
+    for (const auto& column : writers)
+    {
+        auto slot = table->slots + table->size;
+        SetNil(slot);
+        table->size++;
+
+        if (columns & column.first)
+            sc::write_array<std::vector<net::node_base*>, net::node_base*>
+                    (g, slot, nodes, column.second);
+    }
 
     return errNone;
 }
 
-void make_node_sheet(net::node_base& node, std::vector<ossia::value>& destination,
-                     bool with_attributes = false, bool parameters_only = false)
+int pyr_node_snapshot(vmglobals *g, int n)
 {
-    std::vector<ossia::value>  sheet;
-    auto parameter = node.get_parameter();
-
-    if (parameters_only && !parameter) return;
+    // flat [sym, value, sym, value...] array, for Synth creation
+    pyrslot *rcvr       = g->sp-1,
+            *pr_exclude = g->sp;
 
-    auto fullpath = ossia::net::osc_parameter_string(node);
+    std::unordered_set<const net::node_base*> excluded_nodes;
+    std::unordered_set<PyrSymbol*> excluded_syms;
 
-    std::stringstream ptr_stream;
-    ptr_stream << &node;
+    if (!IsNil(pr_exclude))
+    {
+        auto exclude = slotRawObject(pr_exclude);
+        for (int i = 0; i < exclude->size; ++i)
+        {
+            auto item = exclude->slots+i;
+            if      (IsSym(item)) excluded_syms.insert(slotRawSymbol(item));
+            else try              { excluded_nodes.insert(sc::get_node(item)); }
+            catch   ( const std::exception &e )
+            {
+                ERROTP      (e, ERR_HDR, "Exclude argument, expected parameters or symbols.");
+                return      errFailed;
+            }
+        }
+    }
 
-    sheet.push_back(fullpath);
-    sheet.push_back(ptr_stream.str());
+    std::vector<net::node_base*> nodes;
+    auto root = sc::get_node(rcvr);
+    sc::expand(*root, -1);
+    collect_nodes(*root, nodes, true);
 
-    if  ( parameter ) sheet.push_back(parameter->value());
+    std::vector<std::pair<PyrSymbol*, net::parameter_base*>> args;
+    args.reserve(nodes.size());
 
-    if( with_attributes )
+    for (auto node : nodes)
     {
-        auto type   = net::get_value_type(node).value_or(ossia::val_type::NONE);
-        auto amode  = net::get_access_mode(node);
-        auto bmode  = net::get_bounding_mode(node);
-
-        sheet.push_back(format_listed_attribute<ossia::val_type>(type, g_typemap));
-        sheet.push_back(format_listed_attribute<access_mode>(*amode, g_accessmap));
-        sheet.push_back(format_listed_attribute<bounding_mode>(*bmode, g_bmodemap));
-        sheet.push_back(net::get_description(node).value_or("no description"));
-        //res_c.push_back(net::get_tags(*child).value_or("nil"));
-        sheet.push_back(net::get_critical(node));
-        sheet.push_back((bool)net::get_repetition_filter(node));
+        if (excluded_nodes.count(node)) continue;
+        auto sym = sc::parameter_symbol(*node);
+        if (excluded_syms.count(sym)) continue;
+        args.emplace_back(sym, node->get_parameter());
     }
 
-    destination.push_back(sheet);
-}
+    auto array = newPyrArray(g->gc, args.size() * 2, 0, true);
+    SetObject(rcvr, array);
 
-void explore(net::node_base& node, std::vector<ossia::value>& tree,
-             bool with_attributes = false, bool parameters_only = false)
-{
-    for (const auto& child : node.children_copy())
+    for (const auto& arg : args)
     {
-        make_node_sheet(*child, tree, with_attributes, parameters_only);
-        explore(*child, tree, with_attributes, parameters_only);
+        SetSymbol       (array->slots+array->size, arg.first);
+        array->size++;
+        sc::write_value (g, array->slots+array->size, arg.second->value());
+        array->size++;
     }
-}
-
-int pyr_node_get_sheet(vmglobals *g, int n)
-{
-    std::vector<ossia::value> sheet;
-    make_node_sheet(*sc::get_node(g->sp), sheet, true, false);
 
-    sc::write_value(g, g->sp, sheet);
     return errNone;
 }
 
-int pyr_node_explore(vmglobals *g, int n)
+int pyr_parameter_get_symbol(vmglobals *g, int n)
 {
-    // also used to make synth argument arrays
-    auto node = sc::get_node(g->sp-2);
-    std::vector<ossia::value> tree;
-    explore(*node, tree, IsTrue(g->sp-1), IsTrue(g->sp));
-
-    sc::write_value(g, g->sp-2, tree);
-
+    SetSymbol(g->sp, sc::parameter_symbol(*sc::get_node(g->sp)));
     return errNone;
 }
 
@@ -806,22 +3984,22 @@ int pyr_node_get_tags(vmglobals *g, int n)
 
 int pyr_parameter_get_value(vmglobals *g, int n)
 {
-    auto param = sc::get_node(g->sp)->get_parameter();
+    auto param = sc::get_parameter(g->sp);
     sc::write_value(g, g->sp, param->value());
     return errNone;
 }
 
 int pyr_parameter_get_access_mode(vmglobals *g, int n)
 {
-    auto amode          = net::get_access_mode(*sc::get_node(g->sp));
-    auto amode_str      = sc::format_listed_attribute<access_mode>(*amode, g_accessmap);
+    auto amode          = sc::get_parameter(g->sp)->get_access();
+    auto amode_str      = sc::format_listed_attribute<access_mode>(amode, g_accessmap);
     sc::write_string    (g, g->sp, amode_str);
     return              errNone;
 }
 
 int pyr_parameter_get_domain(vmglobals *g, int n)
 {
-    auto domain = net::get_domain(*sc::get_node(g->sp));
+    auto domain = sc::get_parameter(g->sp)->get_domain();
     std::vector<ossia::value> sc_domain;
 
     auto min = ossia::get_min(domain);
@@ -849,7 +4027,7 @@ int pyr_parameter_get_domain(vmglobals *g, int n)
 
 int pyr_parameter_get_bounding_mode(vmglobals *g, int n)
 {
-    auto bmode          = *net::get_bounding_mode(*sc::get_node(g->sp));
+    auto bmode          = sc::get_parameter(g->sp)->get_bounding();
     auto bmode_str      = sc::format_listed_attribute<bounding_mode>(bmode, g_bmodemap);
     sc::write_string    (g, g->sp, bmode_str);
     return              errNone;
@@ -857,7 +4035,7 @@ int pyr_parameter_get_bounding_mode(vmglobals *g, int n)
 
 int pyr_parameter_get_critical(vmglobals *g, int n)
 {
-    auto        critical = net::get_critical(*sc::get_node(g->sp));
+    auto        critical = sc::get_parameter(g->sp)->get_critical();
     SetBool     (g->sp, critical);
     return      errNone;
 }
@@ -865,14 +4043,14 @@ int pyr_parameter_get_critical(vmglobals *g, int n)
 int pyr_parameter_get_repetition_filter(vmglobals *g, int n)
 {
     auto        rep_filter = static_cast<bool>
-                (net::get_repetition_filter(*sc::get_node(g->sp)));
+                (sc::get_parameter(g->sp)->get_repetition_filter());
     SetBool     (g->sp, rep_filter);
     return      errNone;
 }
 
 int pyr_parameter_get_unit(vmglobals *g, int n)
 {
-    auto unit           = net::get_unit(*sc::get_node(g->sp));
+    auto unit           = sc::get_parameter(g->sp)->get_unit();
     auto unit_txt       = get_pretty_unit_text(unit);
     sc::write_string    (g, g->sp, unit_txt);
     return              errNone;
@@ -880,7 +4058,7 @@ int pyr_parameter_get_unit(vmglobals *g, int n)
 
 int pyr_parameter_get_priority(vmglobals *g, int n)
 {
-    auto    priority = *net::get_priority(*sc::get_node(g->sp));
+    auto    priority = net::get_priority(*sc::get_node(g->sp)).value_or(0);
     SetInt  (g->sp, (int) priority);
     return  errNone;
 }
@@ -918,56 +4096,69 @@ int pyr_parameter_set_value(vmglobals *g, int n)
     // problem with this, is, callback is triggered before the end of the primitive
     // makes the interpreter crash.. so we have to set it quiet
     auto value  = sc::read_value(g->sp);
-    auto param  = sc::get_node(g->sp-1)->get_parameter();
+    auto param  = sc::get_parameter(g->sp-1);
     param       ->set_value_quiet(value);
-    param       ->get_node().get_device().get_protocol().push(*param);
+    sc::push_parameter(*param);
     return      errNone;
 }
 
-int pyr_parameter_set_callback(vmglobals *g, int n)
+int finalize_parameter(vmglobals *g, pyrobject *object)
 {
-    pyrobject* obj  = slotRawObject(g->sp);
-    auto param      = sc::get_node(g->sp)->get_parameter();
-
-    param->add_callback([=](const ossia::value& v)
+    // runs when an OSSIA_Parameter holding callbacks is collected,
+    // the ids it still knows about are unregistered along with their lambdas
+    for (auto slot : { PARAMETER_CALLBACK_ID_SLOT, PARAMETER_BINDING_ID_SLOT })
     {
-        uint8_t numArgs = 2;
-        gLangMutex.lock();
+        if  (!IsInt(object->slots+slot)) continue;
 
-        if (compiledOK)
-        {
-            g->canCallOS        = true;
-            ++g->sp;            SetObject(g->sp, obj);
-            ++g->sp;            ossia::sc::write_value(g, g->sp, param->value() );
-            runInterpreter      (g, getsym(SCCBACK_NAME), numArgs);
-            g->canCallOS        = false;
-        }
+        auto id     = slotRawInt(object->slots+slot);
+        auto param  = g_callbacks.parameter(id);
+        if  (param && g_callbacks.remove(id)) sc::update_listening(*param);
+    }
 
-        gLangMutex.unlock();
+    return errNone;
+}
 
-    });
+int pyr_parameter_add_callback(vmglobals *g, int n)
+{
+    // returns the callback's id, the sc function itself is kept by OSSIA_Parameter,
+    // which the registry only refers to weakly
+    auto param  = sc::get_parameter(g->sp);
+    auto object = slotRawObject(g->sp);
 
+    if (!IsObj(object->slots+PARAMETER_FINALIZER_SLOT))
+        InstallFinalizer(g, object, PARAMETER_FINALIZER_SLOT, finalize_parameter);
+
+    SetInt(g->sp, g_callbacks.add(*param, object));
+
+    // the first callback subscribes the parameter, unless the device listens to nothing
+    sc::update_listening(*param);
     return errNone;
 }
 
 int pyr_parameter_remove_callback(vmglobals *g, int n)
 {
-    auto    param = sc::get_node(g->sp)->get_parameter();
-    param   ->callbacks_clear();
-    return  errNone;
+    // stale ids (e.g. of a removed parameter) are ignored
+    if (IsInt(g->sp) && g_callbacks.remove(slotRawInt(g->sp)))
+    {
+        auto node = sc::get_node(g->sp-1);
+        if  (auto param = node->get_parameter()) sc::update_listening(*param);
+    }
+
+    SetNil(g->sp-1);
+    return errNone;
 }
 
 int pyr_parameter_set_access_mode(vmglobals *g, int n)
 {
     auto amode  = sc::read_listed_attribute<ossia::access_mode>(g->sp, g_accessmap);
-    auto param  = sc::get_node(g->sp-1)->get_parameter();
+    auto param  = sc::get_parameter(g->sp-1);
     param       ->set_access(amode);
     return      errNone;
 }
 
 int pyr_parameter_set_domain(vmglobals *g, int n)
 {
-    auto param  = sc::get_node(g->sp-1)->get_parameter();
+    auto param  = sc::get_parameter(g->sp-1);
     auto domain = sc::read_domain(g->sp, param->get_value_type());
     param       ->set_domain(domain);
     return      errNone;
@@ -976,14 +4167,14 @@ int pyr_parameter_set_domain(vmglobals *g, int n)
 int pyr_parameter_set_bounding_mode(vmglobals *g, int n)
 {
    auto bmode   = sc::read_listed_attribute<bounding_mode>(g->sp, g_bmodemap);
-   auto param   = sc::get_node(g->sp-1)->get_parameter();
+   auto param   = sc::get_parameter(g->sp-1);
    param        ->set_bounding(bmode);
    return       errNone;
 }
 
 int pyr_parameter_set_repetition_filter(vmglobals *g, int n)
 {
-    auto param      = sc::get_node(g->sp-1)->get_parameter();
+    auto param      = sc::get_parameter(g->sp-1);
     auto rfilter    = static_cast<repetition_filter>(IsTrue(g->sp));
     param           ->set_repetition_filter(rfilter);
 
@@ -993,7 +4184,7 @@ int pyr_parameter_set_repetition_filter(vmglobals *g, int n)
 int pyr_parameter_set_unit(vmglobals *g, int n)
 {
     auto unit       = ossia::parse_pretty_unit(sc::read_string(g->sp));
-    auto param      = sc::get_node(g->sp-1)->get_parameter();
+    auto param      = sc::get_parameter(g->sp-1);
     param           ->set_unit(unit);
 
     return          errNone;
@@ -1007,7 +4198,7 @@ int pyr_parameter_set_priority(vmglobals *g, int n)
 
 int pyr_parameter_set_critical(vmglobals *g, int n)
 {
-    ossia::net::set_critical(*sc::get_node(g->sp-1), IsTrue(g->sp));
+    sc::get_parameter(g->sp-1)->set_critical(IsTrue(g->sp));
     return errNone;
 }
 
@@ -1066,15 +4257,482 @@ int pyr_preset_save(vmglobals *g, int n)
     return errNone;
 }
 
+bool is_within(const net::node_base& node, const net::node_base& ancestor) noexcept
+{
+    for (auto n = &node; n; n = n->get_parent())
+        if (n == &ancestor) return true;
+
+    return false;
+}
+
+int pyr_node_diff(vmglobals *g, int n)
+{
+    // returns the [path, value...] entries of source that differ from the live tree,
+    // and optionally pushes only those
+    pyrslot *rcvr       = g->sp-2,
+            *pr_source  = g->sp-1,
+            *pr_apply   = g->sp;
+
+    std::string classname;
+    try     { classname = sc::check_argument_type(pr_source, { "String", "Symbol", "Array" }); }
+    catch   ( const std::exception &e )
+    {
+        ERROTP      (e, ERR_HDR, "Source argument, expected a preset file path or a [path, value...] array.");
+        return      errFailed;
+    }
+
+    auto node   = sc::get_node(rcvr);
+    bool apply  = IsTrue(pr_apply);
+    std::vector<ossia::value> delta;
+
+    if (classname == "Array")
+    {
+        // paths are full osc paths, as returned by explore,
+        // those outside of the receiver's subtree are skipped
+        auto source = slotRawObject(pr_source);
+        auto& root  = node->get_device().get_root_node();
+
+        for (int i = 0; i + 1 < source->size; i += 2)
+        {
+            net::node_base* target;
+            ossia::value value;
+
+            try
+            {
+                target  = sc::find_node(root, sc::read_string(source->slots+i));
+                value   = sc::read_value(source->slots+i+1);
+            }
+            catch   ( const std::exception &e )
+            {
+                ERROTP      (e, ERR_HDR, "Source entry, skipping.");
+                continue;
+            }
+
+            if (!target || !target->get_parameter() || !is_within(*target, *node)) continue;
+
+            // sc reads numbers and vecs loosely (an Integer as a float, a vec as a list),
+            // compared and pushed as the parameter's own type, as received OSC is
+            auto parameter = target->get_parameter();
+            value          = ossia::convert(value, parameter->get_value_type());
+            if (parameter->value() == value) continue;
+
+            delta.push_back(net::osc_parameter_string(*target));
+            delta.push_back(value);
+
+            if (apply) parameter->push_value(value);
+        }
+    }
+    else
+    {
+        std::ifstream ifs(sc::read_string(pr_source));
+        std::string json;
+        json.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+
+        ossia::presets::preset saved, changed;
+        try     { saved = ossia::presets::read_json(json); }
+        catch   ( const std::exception &e )
+        {
+            ERROTP      (e, ERR_HDR, "Could not read preset file.");
+            return      errFailed;
+        }
+
+        // both presets come from make_preset, so their keys can be compared as is
+        auto live = ossia::presets::make_preset(*node);
+        std::unordered_map<std::string, const ossia::value*> current;
+        for (const auto& entry : live)
+            current.emplace(entry.first, &entry.second);
+
+        for (const auto& entry : saved)
+        {
+            auto it = current.find(entry.first);
+            if  (it != current.end() && *it->second == entry.second) continue;
+
+            changed.push_back(entry);
+            delta.push_back(entry.first);
+            delta.push_back(entry.second);
+        }
+
+        if (apply && !changed.empty())
+            ossia::presets::apply_preset(*node, changed);
+    }
+
+    // paths as symbols, like explore_columns
+    auto array = newPyrArray(g->gc, delta.size(), 0, true);
+    SetObject(rcvr, array);
+
+    for (std::size_t i = 0; i < delta.size(); ++i)
+    {
+        if (i % 2 == 0) sc::write_symbol(g, array->slots+i, delta[i].get<std::string>());
+        else            sc::write_value(g, array->slots+i, delta[i]);
+        array->size++;
+    }
+
+    return errNone;
+}
+
+int pyr_device_get_upsert(vmglobals *g, int n)
+{
+    auto binding = sc::get_binding(sc::get_device(g->sp));
+    SetBool(g->sp, binding && binding->upsert);
+    return errNone;
+}
+
+int pyr_device_set_upsert(vmglobals *g, int n)
+{
+    auto binding = sc::get_binding(sc::get_device(g->sp-1));
+    if  (binding) binding->upsert = IsTrue(g->sp);
+    return errNone;
+}
+
+void update_listening_subtree(net::node_base& node)
+{
+    if (auto parameter = node.get_parameter()) sc::update_listening(*parameter);
+    for (const auto& child : node.children_copy())
+        update_listening_subtree(*child);
+}
+
+int pyr_device_get_listen(vmglobals *g, int n)
+{
+    auto binding = sc::get_binding(sc::get_device(g->sp));
+    auto mode    = binding ? binding->listen : LISTEN_SELECTIVE;
+    SetSymbol(g->sp, getsym(sc::format_listed_attribute<listen_mode>(mode, g_listenmap).c_str()));
+    return errNone;
+}
+
+int pyr_device_set_listen(vmglobals *g, int n)
+{
+    listen_mode mode;
+    try     { mode = sc::read_listed_attribute<listen_mode>(g->sp, g_listenmap); }
+    catch   ( const std::exception &e )
+    {
+        ERROTP      (e, ERR_HDR, "Listen mode argument, expected 'selective', 'all' or 'none'.");
+        return      errFailed;
+    }
+
+    auto& device    = sc::get_device(g->sp-1);
+    auto  binding   = sc::get_binding(device);
+    if  (!binding || binding->listen == mode) return errNone;
+
+    binding->listen = mode;
+    update_listening_subtree(device.get_root_node());
+    return errNone;
+}
+
+int pyr_device_begin_edit(vmglobals *g, int n)
+{
+    auto binding = sc::get_binding(sc::get_device(g->sp));
+    if  (binding) binding->edit.depth++;
+    return errNone;
+}
+
+int pyr_device_commit(vmglobals *g, int n)
+{
+    // nested transactions are only committed by the outermost commit
+    auto binding = sc::get_binding(sc::get_device(g->sp));
+    if  (!binding || !binding->edit.active()) return errNone;
+
+    if  (--binding->edit.depth == 0)
+         binding->edit.commit();
+
+    return errNone;
+}
+
+ossia::sc::teardown_queue::~teardown_queue()
+{
+    g_exiting = true;
+    auto deadline = std::chrono::steady_clock::now() + SHUTDOWN_TIMEOUT;
+
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        m_state->stop = true;
+    }
+
+    m_state->condition.notify_one();
+    if (m_thread.joinable()) finish_thread(m_thread, m_state->done, deadline);
+}
+
+void ossia::sc::teardown_queue::push(std::unique_ptr<net::device_base> device,
+                                     std::unique_ptr<node_pools> pools,
+                                     std::function<void()> done)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        m_state->jobs.push_back({ std::move(device), std::move(pools), std::move(done) });
+        if (!m_thread.joinable()) m_thread = std::thread([shared = m_state] { run(shared); });
+    }
+
+    m_state->condition.notify_one();
+}
+
+void ossia::sc::teardown_queue::run(std::shared_ptr<state> shared)
+{
+    auto& st = *shared;
+    std::unique_lock<std::mutex> lock(st.mutex);
+
+    for (;;)
+    {
+        st.condition.wait(lock, [&st] { return st.stop || !st.jobs.empty(); });
+        if (st.jobs.empty()) break;
+
+        auto job = std::move(st.jobs.front());
+        st.jobs.pop_front();
+        lock.unlock();
+
+        // pooled nodes are released with the device, so its pools must outlive it
+        job.device.reset();
+        job.pools.reset();
+
+        // completions take the language lock, which may be held by a thread waiting in push()
+        lock.lock();
+        if (!job.done || st.stop) continue;
+
+        lock.unlock();
+        job.done();
+        lock.lock();
+    }
+
+    st.done = true;
+}
+
+void detach_subtree(net::node_base& node)
+{
+    // sc callbacks must not fire once the device is handed over to another thread
+    if (auto parameter = node.get_parameter())
+        parameter->callbacks_clear();
+
+    for (const auto& child : node.children_copy())
+        detach_subtree(*child);
+}
+
 int pyr_free_device(vmglobals *g, int n)
 {
-    auto    device = dynamic_cast<net::generic_device*>(sc::get_node(g->sp));
-    delete  device;
+    pyrslot *rcvr       = g->sp-2,
+            *pr_async   = g->sp-1,
+            *pr_id      = g->sp;
+
+    auto    device = &sc::get_device(rcvr);
+    sc::forget_subtree(device->get_root_node());
+
+    auto    pools = std::move(sc::get_binding(*device)->pools);
+    g_bindings.erase(device);
+    forget_cursors(*device);
+
+    if (IsTrue(pr_async))
+    {
+        device->on_node_removing.disconnect<&on_node_removing>();
+        device->on_parameter_removing.disconnect<&on_parameter_removing>();
+        device->on_node_renamed.disconnect<&on_node_renamed>();
+        detach_subtree(device->get_root_node());
+
+        // OSSIA_Device.pvOnFreed(id) runs the sc completion callback, if any
+        std::function<void()> done;
+        if (IsInt(pr_id)) done = [g, id = slotRawInt(pr_id)]
+        {
+            if (!sc::lock_language()) return;
+
+            if (compiledOK)
+            {
+                g->canCallOS        = true;
+                ++g->sp;            SetObject(g->sp, getsym("OSSIA_Device")->u.classobj);
+                ++g->sp;            SetInt(g->sp, id);
+                runInterpreter      (g, getsym("pvOnFreed"), 2);
+                g->canCallOS        = false;
+            }
+
+            gLangMutex.unlock();
+        };
+
+        g_teardowns.push(std::unique_ptr<net::device_base>(device), std::move(pools), std::move(done));
+    }
+    else
+    {
+        delete  device;
+        pools.reset();
+    }
 
-    auto device_obj = slotRawObject(g->sp);
+    auto device_obj = slotRawObject(rcvr);
     g->gc->Free(device_obj);
-    SetNil(g->sp);
+    SetNil(rcvr);
+
+    return errNone;
+}
+
+void write_field(vmglobals *g, pyrslot *target, const std::pair<const char*, std::size_t>& field) noexcept
+{
+    auto pair = newPyrArray(g->gc, 2, 0, true);
+    SetObject(target, pair);
+
+    // byte counts may not fit in a 32-bit sc Integer
+    SetSymbol(pair->slots, getsym(field.first));
+    if (field.second > INT32_MAX) SetFloat(pair->slots+1, static_cast<double>(field.second));
+    else SetInt(pair->slots+1, static_cast<int>(field.second));
+    pair->size = 2;
+}
+
+std::vector<std::pair<const char*, double>> stats_fields(const protocol_stats& stats)
+{
+    std::vector<std::pair<const char*, double>> fields
+    {
+        { "messages_in", static_cast<double>(stats.messages_in) },
+        { "messages_out", static_cast<double>(stats.messages_out) },
+        { "encode_time", static_cast<double>(stats.encode_ns) * 1e-9 },
+        { "errors", static_cast<double>(stats.errors) }
+    };
+
+    // unknown counters are left out rather than reported as zero
+    if (stats.clients >= 0) fields.push_back({ "clients", static_cast<double>(stats.clients) });
+
+    if (stats.transport)
+    {
+        fields.push_back({ "bytes_in", static_cast<double>(stats.bytes_in) });
+        fields.push_back({ "bytes_out", static_cast<double>(stats.bytes_out) });
+        fields.push_back({ "queue_depth", static_cast<double>(stats.queue_depth) });
+        fields.push_back({ "dropped", static_cast<double>(stats.dropped) });
+    }
+
+    return fields;
+}
+
+void write_stats_field(vmglobals *g, pyrslot *target, const std::pair<const char*, double>& field) noexcept
+{
+    auto pair = newPyrArray(g->gc, 2, 0, true);
+    SetObject(target, pair);
+
+    SetSymbol(pair->slots, getsym(field.first));
+    if (field.second == std::floor(field.second) && field.second <= INT32_MAX)
+         SetInt(pair->slots+1, static_cast<int>(field.second));
+    else SetFloat(pair->slots+1, field.second);
+    pair->size = 2;
+}
+
+void write_protocol_stats(vmglobals *g, pyrslot *target, const std::shared_ptr<protocol_stats>& stats) noexcept
+{
+    auto fields = stats_fields(*stats);
+    auto array  = newPyrArray(g->gc, fields.size()+1, 0, true);
+    SetObject(target, array);
+
+    auto name   = newPyrArray(g->gc, 2, 0, true);
+    SetObject(array->slots, name);
+    array->size++;
+
+    SetSymbol(name->slots, getsym("protocol"));
+    SetSymbol(name->slots+1, getsym(stats->name.c_str()));
+    name->size = 2;
+
+    for (std::size_t i = 0; i < fields.size(); ++i)
+    {
+        write_stats_field(g, array->slots+i+1, fields[i]);
+        array->size++;
+    }
+}
+
+int pyr_device_stats(vmglobals *g, int n)
+{
+    // returns one [[\protocol, name], [key, count]...] array per exposed protocol
+    auto binding = sc::get_binding(sc::get_device(g->sp));
+    if  (!binding) throw NODE_NOT_FOUND;
+
+    sc::write_array<decltype(binding->stats), std::shared_ptr<protocol_stats>>(
+                g, g->sp, binding->stats, write_protocol_stats);
+    return errNone;
+}
+
+int pyr_device_publish_stats(vmglobals *g, int n)
+{
+    // mirrors the counters as read-only parameters under /_stats/<protocol>/<key>
+    auto& device    = sc::get_device(g->sp);
+    auto  binding   = sc::get_binding(device);
+    if  (!binding) throw NODE_NOT_FOUND;
+
+    auto& root = device.get_root_node();
+
+    for (const auto& stats : binding->stats)
+    {
+        for (const auto& field : stats_fields(*stats))
+        {
+            auto path = "_stats/" + stats->name + "/" + field.first;
+            auto node = sc::find_node(root, path);
+            if  (!node) node = &sc::create_child(root, path);
+
+            bool integer = std::strcmp(field.first, "encode_time") != 0;
+            auto param   = node->get_parameter();
+
+            if (!param)
+            {
+                param = node->create_parameter(integer ? ossia::val_type::INT : ossia::val_type::FLOAT);
+                param->set_access(ossia::access_mode::GET);
+            }
+
+            if   (integer) param->set_value_quiet(static_cast<int32_t>(std::min<double>(field.second, INT32_MAX)));
+            else param->set_value_quiet(static_cast<float>(field.second));
+
+            sc::push_parameter(*param);
+        }
+    }
+
+    return errNone;
+}
+
+int pyr_node_footprint(vmglobals *g, int n)
+{
+    // returns [[key, count]...] pairs, turned into an Event on the sc side
+    auto fp = sc::measure_footprint(*sc::get_node(g->sp));
+
+    std::vector<std::pair<const char*, std::size_t>> fields
+    {
+        { "nodes", fp.nodes },
+        { "parameters", fp.parameters },
+        { "callbacks", fp.callbacks },
+        { "protocols", fp.protocols },
+        { "node_bytes", fp.node_bytes },
+        { "value_bytes", fp.value_bytes },
+        { "attribute_bytes", fp.attribute_bytes },
+        { "binding_bytes", fp.binding_bytes },
+        { "pool_bytes", fp.pool_bytes },
+        { "total_bytes", fp.node_bytes + fp.value_bytes + fp.attribute_bytes
+                       + fp.binding_bytes + fp.pool_bytes }
+    };
+
+    sc::write_array<decltype(fields), std::pair<const char*, std::size_t>>(g, g->sp, fields, write_field);
+    return errNone;
+}
+
+int pyr_alloc_debug_set(vmglobals *g, int n)
+{
+#ifdef OSSIA_ALLOC_DEBUG
+    g_alloc_debug = IsTrue(g->sp);
+#else
+    std::cout << HDR << WRN_HDR << "allocation tracking requires a build with OSSIA_ALLOC_DEBUG" << std::endl;
+#endif
+    return errNone;
+}
+
+int pyr_alloc_debug_report(vmglobals *g, int n)
+{
+    // returns [name, calls, allocations, bytes] for each primitive called while tracking
+    pyrslot *rcvr       = g->sp-1,
+            *pr_reset   = g->sp;
+
+    std::vector<ossia::value> report;
+
+#ifdef OSSIA_ALLOC_DEBUG
+    for (const auto& record : g_alloc_records)
+    {
+        if (!record.second.calls) continue;
+        report.push_back(std::vector<ossia::value>
+        {
+            g_primitive_names[record.first],
+            static_cast<int>(record.second.calls),
+            static_cast<int>(record.second.allocations),
+            static_cast<int>(std::min<std::size_t>(record.second.bytes, INT32_MAX))
+        });
+    }
+
+    // records are zeroed rather than erased, the current primitive's scope still points into the map
+    if (IsTrue(pr_reset)) for (auto& record : g_alloc_records) record.second = alloc_record();
+#endif
 
+    sc::write_value(g, rcvr, report);
     return errNone;
 }
 
@@ -1083,69 +4741,122 @@ int pyr_ossia_tests(vmglobals *g, int n)
     return errNone;
 }
 
+template<int (*primitive)(vmglobals*, int)>
+int guarded(vmglobals *g, int n)
+{
+#ifdef OSSIA_ALLOC_DEBUG
+    std::unique_ptr<alloc_scope> scope;
+    if (g_alloc_debug) scope = std::make_unique<alloc_scope>(g_alloc_records[&guarded<primitive>]);
+#endif
+
+    // stale handles and bad arguments fail the primitive instead of unwinding into the interpreter
+    try     { return primitive(g, n); }
+    catch   ( const std::exception &e )
+    {
+        ERROTP      (e, ERR_HDR, "");
+        return      errFailed;
+    }
+}
+
+void define_primitive(int base, int index, const char *name, PrimitiveHandler handler,
+                      int numArgs, int varArgs)
+{
+#ifdef OSSIA_ALLOC_DEBUG
+    g_primitive_names[handler] = name;
+#endif
+    definePrimitive(base, index, name, handler, numArgs, varArgs);
+}
+
 void initOssiaPrimitives() {
 
     int base, index = 0;
     base = nextPrimitiveIndex();
 
-    definePrimitive(base, index++, "_OSSIA_Tests", pyr_ossia_tests, 1, 0);
-    definePrimitive(base, index++, "_OSSIA_DeviceSetLogger", pyr_device_set_logger, 1, 0);
-    definePrimitive(base, index++, "_OSSIA_DeviceRemoveLogger", pyr_device_remove_logger, 1, 0);
-
-    definePrimitive(base, index++, "_OSSIA_InstantiateDevice", pyr_instantiate_device, 2, 0);
-    definePrimitive(base, index++, "_OSSIA_ExposeOSCQueryServer", pyr_expose_oscquery_server, 3, 0);
-    definePrimitive(base, index++, "_OSSIA_ExposeOSCQueryMirror", pyr_expose_oscquery_mirror, 2, 0);
-    definePrimitive(base, index++, "_OSSIA_ExposeMinuit", pyr_expose_minuit, 4, 0);
-    definePrimitive(base, index++, "_OSSIA_ExposeOSC", pyr_expose_osc, 4, 0);
-
-    definePrimitive(base, index++, "_OSSIA_ZeroConfExplore", pyr_zeroconf_explore, 1, 0);
-
-    definePrimitive(base, index++, "_OSSIA_InstantiateParameter", pyr_instantiate_parameter, 9, 0);
-    definePrimitive(base, index++, "_OSSIA_InstantiateNode", pyr_instantiate_node, 3, 0);
-
-    definePrimitive(base, index++, "_OSSIA_NodeExplore", pyr_node_explore, 3, 0);
-    definePrimitive(base, index++, "_OSSIA_NodeGetName", pyr_node_get_name, 1, 0);
-    definePrimitive(base, index++, "_OSSIA_NodeGetChildrenNames", pyr_node_get_children_names, 1, 0);
-    definePrimitive(base, index++, "_OSSIA_NodeGetFullPath", pyr_node_get_full_path, 1, 0);
-    definePrimitive(base, index++, "_OSSIA_NodeGetDisabled", pyr_node_get_disabled, 1, 0);
-    definePrimitive(base, index++, "_OSSIA_NodeGetHidden", pyr_node_get_hidden, 1, 0);
-    definePrimitive(base, index++, "_OSSIA_NodeGetMuted", pyr_node_get_muted, 1, 0);
-    definePrimitive(base, index++, "_OSSIA_NodeGetDescription", pyr_node_get_description, 1, 0);
-    definePrimitive(base, index++, "_OSSIA_NodeGetTags", pyr_node_get_tags, 1, 0);
-    definePrimitive(base, index++, "_OSSIA_NodeGetZombie", pyr_node_get_zombie, 1, 0);
-    definePrimitive(base, index++, "_OSSIA_NodeGetMirror", pyr_node_get_mirror, 3, 0);
-    definePrimitive(base, index++, "_OSSIA_NodeFree", pyr_node_free, 1, 0);
-
-    definePrimitive(base, index++, "_OSSIA_NodeSetDisabled", pyr_node_set_disabled, 2, 0);
-    definePrimitive(base, index++, "_OSSIA_NodeSetHidden", pyr_node_set_hidden, 2, 0);
-    definePrimitive(base, index++, "_OSSIA_NodeSetMuted", pyr_node_set_muted, 2, 0);
-    definePrimitive(base, index++, "_OSSIA_NodeSetDescription", pyr_node_set_description, 2, 0);
-    definePrimitive(base, index++, "_OSSIA_NodeSetTags", pyr_node_set_tags, 2, 0);
-
-    definePrimitive(base, index++, "_OSSIA_ParameterSetValue", pyr_parameter_set_value, 2, 0);
-    definePrimitive(base, index++, "_OSSIA_ParameterSetCallback", pyr_parameter_set_callback, 1, 0);
-    definePrimitive(base, index++, "_OSSIA_ParameterRemoveCallback", pyr_parameter_remove_callback, 1, 0);
-    definePrimitive(base, index++, "_OSSIA_ParameterSetAccessMode", pyr_parameter_set_access_mode, 2, 0);
-    definePrimitive(base, index++, "_OSSIA_ParameterSetDomain", pyr_parameter_set_domain, 2, 0);
-    definePrimitive(base, index++, "_OSSIA_ParameterSetBoundingMode", pyr_parameter_set_bounding_mode, 2, 0);
-    definePrimitive(base, index++, "_OSSIA_ParameterSetRepetitionFilter", pyr_parameter_set_repetition_filter, 2, 0);
-    definePrimitive(base, index++, "_OSSIA_ParameterSetUnit", pyr_parameter_set_unit, 2, 0);
-    definePrimitive(base, index++, "_OSSIA_ParameterSetPriority", pyr_parameter_set_priority, 2, 0);
-    definePrimitive(base, index++, "_OSSIA_ParameterSetCritical", pyr_parameter_set_critical, 2, 0);
-
-    definePrimitive(base, index++, "_OSSIA_ParameterGetValue", pyr_parameter_get_value, 1, 0);
-    definePrimitive(base, index++, "_OSSIA_ParameterGetAccessMode", pyr_parameter_get_access_mode, 1, 0);
-    definePrimitive(base, index++, "_OSSIA_ParameterGetDomain", pyr_parameter_get_domain, 1, 0);
-    definePrimitive(base, index++, "_OSSIA_ParameterGetBoundingMode", pyr_parameter_get_bounding_mode, 1, 0);
-    definePrimitive(base, index++, "_OSSIA_ParameterGetRepetitionFilter", pyr_parameter_get_repetition_filter, 1, 0);
-    definePrimitive(base, index++, "_OSSIA_ParameterGetUnit", pyr_parameter_get_unit, 1, 0);
-    definePrimitive(base, index++, "_OSSIA_ParameterGetPriority", pyr_parameter_get_priority, 1, 0);
-    definePrimitive(base, index++, "_OSSIA_ParameterGetCritical", pyr_parameter_get_critical, 1, 0);
-
-    definePrimitive(base, index++, "_OSSIA_PresetLoad", pyr_preset_load, 2, 0);
-    definePrimitive(base, index++, "_OSSIA_PresetSave", pyr_preset_save, 2, 0);
-
-    definePrimitive(base, index++, "_OSSIA_FreeDevice", pyr_free_device, 1, 0);
+    define_primitive(base, index++, "_OSSIA_Tests", guarded<pyr_ossia_tests>, 1, 0);
+    define_primitive(base, index++, "_OSSIA_DeviceSetLogger", guarded<pyr_device_set_logger>, 1, 0);
+    define_primitive(base, index++, "_OSSIA_DeviceRemoveLogger", guarded<pyr_device_remove_logger>, 1, 0);
+
+    define_primitive(base, index++, "_OSSIA_InstantiateDevice", guarded<pyr_instantiate_device>, 3, 0);
+    define_primitive(base, index++, "_OSSIA_ExposeOSCQueryServer", guarded<pyr_expose_oscquery_server>, 3, 0);
+    define_primitive(base, index++, "_OSSIA_ExposeOSCQueryMirror", guarded<pyr_expose_oscquery_mirror>, 5, 0);
+    define_primitive(base, index++, "_OSSIA_ExposeMinuit", guarded<pyr_expose_minuit>, 4, 0);
+    define_primitive(base, index++, "_OSSIA_DeviceSetExposeFilter", guarded<pyr_device_set_expose_filter>, 3, 0);
+    define_primitive(base, index++, "_OSSIA_ExposeOSC", guarded<pyr_expose_osc>, 5, 0);
+    define_primitive(base, index++, "_OSSIA_ExposeLocal", guarded<pyr_expose_local>, 3, 0);
+
+    define_primitive(base, index++, "_OSSIA_ZeroConfExplore", guarded<pyr_zeroconf_explore>, 1, 0);
+
+    define_primitive(base, index++, "_OSSIA_InstantiateParameter", guarded<pyr_instantiate_parameter>, 9, 0);
+    define_primitive(base, index++, "_OSSIA_InstantiateParameterArray", guarded<pyr_instantiate_parameter_array>, 10, 0);
+    define_primitive(base, index++, "_OSSIA_InstantiateNode", guarded<pyr_instantiate_node>, 3, 0);
+
+    define_primitive(base, index++, "_OSSIA_NodeExplore", guarded<pyr_node_explore>, 7, 0);
+    define_primitive(base, index++, "_OSSIA_NodeExploreColumns", guarded<pyr_node_explore_columns>, 4, 0);
+    define_primitive(base, index++, "_OSSIA_NodeSnapshot", guarded<pyr_node_snapshot>, 2, 0);
+    define_primitive(base, index++, "_OSSIA_NodeGetName", guarded<pyr_node_get_name>, 1, 0);
+    define_primitive(base, index++, "_OSSIA_NodeGetChildrenNames", guarded<pyr_node_get_children_names>, 1, 0);
+    define_primitive(base, index++, "_OSSIA_NodeGetFullPath", guarded<pyr_node_get_full_path>, 1, 0);
+    define_primitive(base, index++, "_OSSIA_NodeGetDisabled", guarded<pyr_node_get_disabled>, 1, 0);
+    define_primitive(base, index++, "_OSSIA_NodeGetHidden", guarded<pyr_node_get_hidden>, 1, 0);
+    define_primitive(base, index++, "_OSSIA_NodeGetMuted", guarded<pyr_node_get_muted>, 1, 0);
+    define_primitive(base, index++, "_OSSIA_NodeGetDescription", guarded<pyr_node_get_description>, 1, 0);
+    define_primitive(base, index++, "_OSSIA_NodeGetTags", guarded<pyr_node_get_tags>, 1, 0);
+    define_primitive(base, index++, "_OSSIA_NodeGetZombie", guarded<pyr_node_get_zombie>, 1, 0);
+    define_primitive(base, index++, "_OSSIA_NodeGetMirror", guarded<pyr_node_get_mirror>, 3, 0);
+    define_primitive(base, index++, "_OSSIA_NodeFree", guarded<pyr_node_free>, 1, 0);
+
+    define_primitive(base, index++, "_OSSIA_NodeSetDisabled", guarded<pyr_node_set_disabled>, 2, 0);
+    define_primitive(base, index++, "_OSSIA_NodeSetHidden", guarded<pyr_node_set_hidden>, 2, 0);
+    define_primitive(base, index++, "_OSSIA_NodeSetMuted", guarded<pyr_node_set_muted>, 2, 0);
+    define_primitive(base, index++, "_OSSIA_NodeSetDescription", guarded<pyr_node_set_description>, 2, 0);
+    define_primitive(base, index++, "_OSSIA_NodeSetTags", guarded<pyr_node_set_tags>, 2, 0);
+
+    define_primitive(base, index++, "_OSSIA_ParameterSetValue", guarded<pyr_parameter_set_value>, 2, 0);
+    define_primitive(base, index++, "_OSSIA_ParameterAddCallback", guarded<pyr_parameter_add_callback>, 1, 0);
+    define_primitive(base, index++, "_OSSIA_ParameterRemoveCallback", guarded<pyr_parameter_remove_callback>, 2, 0);
+    define_primitive(base, index++, "_OSSIA_ParameterSetAccessMode", guarded<pyr_parameter_set_access_mode>, 2, 0);
+    define_primitive(base, index++, "_OSSIA_ParameterSetDomain", guarded<pyr_parameter_set_domain>, 2, 0);
+    define_primitive(base, index++, "_OSSIA_ParameterSetBoundingMode", guarded<pyr_parameter_set_bounding_mode>, 2, 0);
+    define_primitive(base, index++, "_OSSIA_ParameterSetRepetitionFilter", guarded<pyr_parameter_set_repetition_filter>, 2, 0);
+    define_primitive(base, index++, "_OSSIA_ParameterSetUnit", guarded<pyr_parameter_set_unit>, 2, 0);
+    define_primitive(base, index++, "_OSSIA_ParameterSetPriority", guarded<pyr_parameter_set_priority>, 2, 0);
+    define_primitive(base, index++, "_OSSIA_ParameterSetCritical", guarded<pyr_parameter_set_critical>, 2, 0);
+
+    define_primitive(base, index++, "_OSSIA_ParameterGetValue", guarded<pyr_parameter_get_value>, 1, 0);
+    define_primitive(base, index++, "_OSSIA_ParameterGetAccessMode", guarded<pyr_parameter_get_access_mode>, 1, 0);
+    define_primitive(base, index++, "_OSSIA_ParameterGetDomain", guarded<pyr_parameter_get_domain>, 1, 0);
+    define_primitive(base, index++, "_OSSIA_ParameterGetBoundingMode", guarded<pyr_parameter_get_bounding_mode>, 1, 0);
+    define_primitive(base, index++, "_OSSIA_ParameterGetRepetitionFilter", guarded<pyr_parameter_get_repetition_filter>, 1, 0);
+    define_primitive(base, index++, "_OSSIA_ParameterGetUnit", guarded<pyr_parameter_get_unit>, 1, 0);
+    define_primitive(base, index++, "_OSSIA_ParameterGetPriority", guarded<pyr_parameter_get_priority>, 1, 0);
+    define_primitive(base, index++, "_OSSIA_ParameterGetCritical", guarded<pyr_parameter_get_critical>, 1, 0);
+    define_primitive(base, index++, "_OSSIA_ParameterGetSymbol", guarded<pyr_parameter_get_symbol>, 1, 0);
+
+    define_primitive(base, index++, "_OSSIA_ExploreCursorInstantiate", guarded<pyr_explore_cursor_instantiate>, 6, 0);
+    define_primitive(base, index++, "_OSSIA_ExploreCursorNext", guarded<pyr_explore_cursor_next>, 2, 0);
+    define_primitive(base, index++, "_OSSIA_ExploreCursorFree", guarded<pyr_explore_cursor_free>, 1, 0);
+
+    define_primitive(base, index++, "_OSSIA_PresetLoad", guarded<pyr_preset_load>, 2, 0);
+    define_primitive(base, index++, "_OSSIA_PresetSave", guarded<pyr_preset_save>, 2, 0);
+    define_primitive(base, index++, "_OSSIA_NodeDiff", guarded<pyr_node_diff>, 3, 0);
+
+    define_primitive(base, index++, "_OSSIA_DeviceGetUpsert", guarded<pyr_device_get_upsert>, 1, 0);
+    define_primitive(base, index++, "_OSSIA_DeviceSetUpsert", guarded<pyr_device_set_upsert>, 2, 0);
+    define_primitive(base, index++, "_OSSIA_DeviceStats", guarded<pyr_device_stats>, 1, 0);
+    define_primitive(base, index++, "_OSSIA_DevicePublishStats", guarded<pyr_device_publish_stats>, 1, 0);
+    define_primitive(base, index++, "_OSSIA_DeviceGetListen", guarded<pyr_device_get_listen>, 1, 0);
+    define_primitive(base, index++, "_OSSIA_DeviceSetListen", guarded<pyr_device_set_listen>, 2, 0);
+    define_primitive(base, index++, "_OSSIA_DeviceBeginEdit", guarded<pyr_device_begin_edit>, 1, 0);
+    define_primitive(base, index++, "_OSSIA_DeviceCommit", guarded<pyr_device_commit>, 1, 0);
+    define_primitive(base, index++, "_OSSIA_FreeDevice", guarded<pyr_free_device>, 3, 0);
+
+    define_primitive(base, index++, "_OSSIA_TemplateInstantiate", guarded<pyr_template_instantiate>, 2, 0);
+    define_primitive(base, index++, "_OSSIA_TemplateApply", guarded<pyr_template_apply>, 4, 0);
+    define_primitive(base, index++, "_OSSIA_TemplateFree", guarded<pyr_template_free>, 1, 0);
+
+    define_primitive(base, index++, "_OSSIA_NodeFootprint", guarded<pyr_node_footprint>, 1, 0);
+    define_primitive(base, index++, "_OSSIA_AllocDebugSet", guarded<pyr_alloc_debug_set>, 2, 0);
+    define_primitive(base, index++, "_OSSIA_AllocDebugReport", guarded<pyr_alloc_debug_report>, 2, 0);
 
     g_typemap.insert( bmap<val_type>::value_type("Integer", val_type::INT));
     g_typemap.insert( bmap<val_type>::value_type("Boolean", val_type::BOOL));
@@ -1179,4 +4890,17 @@ void initOssiaPrimitives() {
     g_bmodemap.insert( bmap<bounding_mode>::value_type("high", bounding_mode::HIGH));
     g_bmodemap.insert( bmap<bounding_mode>::value_type("low", bounding_mode::LOW));
     g_bmodemap.insert( bmap<bounding_mode>::value_type("wrap", bounding_mode::WRAP));
+
+    g_listenmap.insert( bmap<listen_mode>::value_type("selective", LISTEN_SELECTIVE));
+    g_listenmap.insert( bmap<listen_mode>::value_type("all", LISTEN_ALL));
+    g_listenmap.insert( bmap<listen_mode>::value_type("none", LISTEN_NONE));
+
+    g_columnmap.insert( bmap<explore_column>::value_type("path", COL_PATH));
+    g_columnmap.insert( bmap<explore_column>::value_type("paths", COL_PATH));
+    g_columnmap.insert( bmap<explore_column>::value_type("handle", COL_HANDLE));
+    g_columnmap.insert( bmap<explore_column>::value_type("handles", COL_HANDLE));
+    g_columnmap.insert( bmap<explore_column>::value_type("value", COL_VALUE));
+    g_columnmap.insert( bmap<explore_column>::value_type("values", COL_VALUE));
+    g_columnmap.insert( bmap<explore_column>::value_type("type", COL_TYPE));
+    g_columnmap.insert( bmap<explore_column>::value_type("types", COL_TYPE));
 }
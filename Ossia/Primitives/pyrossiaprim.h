@@ -5,13 +5,31 @@
 #include <ossia/ossia.hpp>
 #include <ossia/network/base/parameter_data.hpp>
 #include <ossia/network/dataspace/dataspace.hpp>
+#include <ossia/network/zeroconf/zeroconf.hpp>
+#include <spdlog/spdlog.h>
 #include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <future>
+#include <condition_variable>
+#include <unordered_map>
+#include <unordered_set>
 #include <iostream>
 #include <exception>
 #include <initializer_list>
 #include <boost/bimap.hpp>
 #include <boost/bimap/multiset_of.hpp>
 
+#if defined(__linux__) || defined(__APPLE__)
+#define OSSIA_SC_DATAGRAM_SOCKETS
+#include <sys/socket.h>
+#endif
+
 using pyrslot   = PyrSlot;
 using pyrobject = PyrObject;
 using vmglobals = VMGlobals;
@@ -26,6 +44,656 @@ template<typename T> using bmap = boost::bimap<std::string,boost::bimaps::multis
  *          with valid sc string/symbol values
  */
 
+enum explore_column :   uint8_t
+{
+                        COL_PATH    = 1 << 0,
+                        COL_HANDLE  = 1 << 1,
+                        COL_VALUE   = 1 << 2,
+                        COL_TYPE    = 1 << 3,
+                        COL_ALL     = COL_PATH | COL_HANDLE | COL_VALUE | COL_TYPE
+};
+/**                     columns that can be requested from a columnar explore,
+ *                      combined as a bitmask
+ */
+
+enum listen_mode :      uint8_t
+{
+                        LISTEN_SELECTIVE,
+                        LISTEN_ALL,
+                        LISTEN_NONE
+};
+/**                     which parameters a device subscribes to (LISTEN) on its remote:
+ *                      those with sc callbacks or bindings, all of them, or none
+ */
+
+class handle_table
+{
+public:
+    int                 insert(net::node_base& node, net::generic_device* device = nullptr,
+                               net::multiplex_protocol* multiplex = nullptr);
+    net::node_base*     find(int handle) const noexcept;
+    net::generic_device*     find_device(int handle) const noexcept;
+    net::multiplex_protocol* find_multiplex(int handle) const noexcept;
+    void                erase(const net::node_base& node) noexcept;
+
+private:
+    static constexpr int GENERATION_BITS = 9;
+    static constexpr uint32_t GENERATION_MASK = (1u << GENERATION_BITS) - 1;
+
+    struct entry
+    {
+        net::node_base*             node;
+        net::generic_device*        device;
+        net::multiplex_protocol*    multiplex;
+        uint32_t                    generation;
+    };
+
+    static constexpr uint32_t MAX_ENTRIES = 1u << (31 - GENERATION_BITS);
+
+    const entry*        get(int handle) const noexcept;
+
+    std::vector<entry>                              m_entries;
+    std::deque<uint32_t>                            m_free;
+    std::unordered_map<const net::node_base*, int>  m_handles;
+};
+/**                     binding-owned table of node handles (index + generation)
+ *                      stored as Integers in sc objects' first slot,
+ *                      handles of removed nodes are invalidated and fail lookup:
+ *                      freed slots are reused oldest first and retired once their
+ *                      generation would wrap, so a stale handle never matches another node
+ */
+
+class callback_registry
+{
+public:
+    int                 add(net::parameter_base& parameter, pyrobject* owner);
+    bool                remove(int id) noexcept;
+    pyrobject*          owner(int id) const noexcept;
+    net::parameter_base* parameter(int id) const noexcept;
+    bool                forget(const net::parameter_base& parameter) noexcept;
+    std::size_t         count() const noexcept { return m_entries.size() - m_free.size() - m_retired; }
+
+private:
+    static constexpr int GENERATION_BITS = 9;
+    static constexpr uint32_t GENERATION_MASK = (1u << GENERATION_BITS) - 1;
+
+    struct entry
+    {
+        net::parameter_base*            parameter;
+        pyrobject*                      owner;      // weak, cleared by the owner's finalizer
+        net::parameter_base::iterator   callback;
+        uint32_t                        generation;
+        uint32_t                        next;       // same parameter's next entry, or NONE
+        uint32_t                        previous;
+    };
+
+    static constexpr uint32_t NONE = UINT32_MAX;
+    static constexpr uint32_t MAX_ENTRIES = 1u << (31 - GENERATION_BITS);
+
+    void                release(uint32_t index) noexcept;
+    const entry*        find(int id) const noexcept;
+
+    std::vector<entry>                                          m_entries;
+    std::deque<uint32_t>                                        m_free;
+    std::size_t                                                 m_retired = 0;
+    std::unordered_map<const net::parameter_base*, uint32_t>    m_heads;
+};
+/**                     parameter callbacks registered from sc, identified by the same index +
+ *                      generation scheme as node handles: removal is O(1) and targeted, freed
+ *                      slots are reused oldest first and retired once their generation would wrap,
+ *                      so that a stale id held by a collected object never matches another callback;
+ *                      native callbacks carry their id and dispatch to their OSSIA_Parameter's
+ *                      pvOnCallback; the owner is held weakly, and a finalizer installed in the
+ *                      object removes its callbacks when it is collected, so that a collected
+ *                      sc object can never be called back
+ */
+
+// OSSIA_Parameter instance slots read natively (after OSSIA_Node's handle in slot 0)
+#define PARAMETER_CALLBACK_ID_SLOT  2
+#define PARAMETER_BINDING_ID_SLOT   3
+#define PARAMETER_FINALIZER_SLOT    4
+
+class path_index
+{
+public:
+    explicit            path_index(net::device_base& device);
+                        ~path_index();
+    net::node_base*     find(const std::string& path) const noexcept;
+    void                insert(net::node_base& node);
+
+private:
+    void                on_node_created(net::node_base& node);
+    void                on_node_removing(const net::node_base& node);
+    void                on_node_renamed(net::node_base& node, std::string old_name);
+    void                insert_subtree(net::node_base& node);
+    void                erase_subtree(const net::node_base& node);
+
+    net::device_base&   m_device;
+    std::unordered_map<std::string, net::node_base*> m_nodes;
+};
+/**                     per-device hash index from full osc path to node,
+ *                      kept up to date from the device's node signals
+ */
+
+class shadow_sync
+{
+public:
+                        shadow_sync(net::device_base& device, net::device_base& shadow);
+                        ~shadow_sync();
+    net::node_base*     counterpart(const net::node_base& node) const;
+    void                pause(bool paused) noexcept { m_paused = paused; }
+
+private:
+    void                on_node_created(net::node_base& node);
+    void                on_node_removing(const net::node_base& node);
+    void                on_node_renamed(net::node_base& node, std::string old_name);
+    void                on_attribute_modified(const net::node_base& node, ossia::string_view attribute);
+    void                on_parameter_created(const net::parameter_base& parameter);
+    void                on_parameter_removing(const net::parameter_base& parameter);
+
+    net::device_base&   m_device;
+    net::device_base&   m_shadow;
+    bool                m_paused = false;
+};
+/**                     replays on a lazy mirror's shadow namespace every change made to the
+ *                      device (e.g. remote nodes added, removed, renamed or edited after the
+ *                      download), so that nodes materialised later on are never built from
+ *                      a stale snapshot
+ */
+
+struct parameter_spec
+{
+    val_type                type;
+    ossia::domain           domain;
+    bounding_mode           bounding = bounding_mode::FREE;
+    ossia::value            default_value;
+    ossia::repetition_filter repetition_filter = ossia::repetition_filter::OFF;
+    bool                    critical = false;
+    ossia::unit_t           unit;
+};
+/**                     parsed parameter attributes, read once from sc arguments
+ *                      and applied to one or many nodes
+ */
+
+struct subtree_template
+{
+    struct entry
+    {
+        std::string                     path;
+        ossia::optional<parameter_spec> spec;
+    };
+
+    std::vector<entry>  entries;
+};
+/**                     subtree layout parsed once from sc, relative paths with their
+ *                      parameter attributes (if any), applied as is to every instance
+ */
+
+struct explore_filter
+{
+    std::vector<std::string>        tags;
+    ossia::optional<val_type>       type;
+    ossia::optional<access_mode>    access;
+    std::string                     unit;
+    ossia::optional<bool>           critical;
+    std::string                     path;
+
+    bool                empty() const noexcept;
+    bool                matches(net::node_base& node) const;
+    bool                operator==(const explore_filter& other) const noexcept;
+};
+/**                     node predicates evaluated during explore traversals,
+ *                      unset fields match everything
+ */
+bool                    glob_match(const char* pattern, const char* path) noexcept;
+/**                     osc path glob: '?' and '*' stop at '/', '**' spans segments,
+ *                      a trailing '/**' matches its parent too; shared by explore and path filters
+ */
+
+class explore_cursor
+{
+public:
+                        explore_cursor(net::node_base& root, int max_depth,
+                                       bool with_attributes, bool parameters_only,
+                                       explore_filter filter = {});
+                        ~explore_cursor();
+    std::size_t         next(std::vector<ossia::value>* destination, std::size_t limit,
+                             std::size_t max_visits = SIZE_MAX);
+    bool                done() const noexcept;
+    net::device_base&   device() const noexcept;
+
+private:
+    struct frame
+    {
+        net::node_base*                 parent;
+        std::vector<net::node_base*>    children;
+        std::size_t                     index;
+        int                             depth;
+    };
+
+    void                on_node_removing(const net::node_base& node);
+
+    net::device_base&   m_device;
+    std::vector<frame>  m_stack;
+    int                 m_max_depth;
+    bool                m_with_attributes;
+    bool                m_parameters_only;
+    explore_filter      m_filter;
+};
+/**                     resumable depth-first walk of a subtree, yielding node sheets in chunks,
+ *                      nodes removed while the cursor is alive are skipped, and the walk
+ *                      ends if its root (or one of its ancestors) is removed
+ */
+
+class block_pool
+{
+public:
+                        block_pool(std::size_t block_size, std::size_t blocks_per_chunk = 1024);
+    void*               allocate();
+    static void         deallocate(void* object) noexcept;
+    std::size_t         used() const noexcept;
+    std::size_t         reserved_bytes() const noexcept;
+
+private:
+    struct header       { block_pool* pool; };
+    static constexpr std::size_t HEADER_SIZE = alignof(std::max_align_t);
+
+    void                release(char* block) noexcept;
+
+    std::size_t                             m_block_size;
+    std::size_t                             m_blocks_per_chunk;
+    std::size_t                             m_used = 0;
+    std::vector<std::unique_ptr<char[]>>    m_chunks;
+    std::vector<char*>                      m_free;
+    mutable std::mutex                      m_mutex;
+};
+/**                     fixed-size block allocator, each block remembers its pool
+ *                      so that objects can be deleted through a base class pointer
+ */
+
+struct node_pools;
+
+class pooled_parameter final : public net::generic_parameter
+{
+public:
+    using               net::generic_parameter::generic_parameter;
+    static void*        operator new(std::size_t size, block_pool& pool);
+    static void         operator delete(void* object) noexcept;
+    static void         operator delete(void* object, block_pool& pool) noexcept;
+};
+
+class pooled_node final : public net::generic_node
+{
+public:
+                        pooled_node(std::string name, net::device_base& device,
+                                    net::node_base& parent, node_pools& pools);
+    net::parameter_base* create_parameter(val_type type) override;
+
+    static void*        operator new(std::size_t size, block_pool& pool);
+    static void         operator delete(void* object) noexcept;
+    static void         operator delete(void* object, block_pool& pool) noexcept;
+
+protected:
+    std::unique_ptr<net::node_base> make_child(const std::string& name) override;
+
+private:
+    node_pools&         m_pools;
+};
+/**                     nodes and parameters allocated from their device's pools,
+ *                      children created under a pooled node are pooled as well
+ */
+
+struct node_pools
+{
+                        node_pools() :
+                        nodes(sizeof(pooled_node)),
+                        parameters(sizeof(pooled_parameter)) {}
+
+    block_pool          nodes;
+    block_pool          parameters;
+};
+/**                     per-device pools, for devices created with pool allocation mode
+ */
+
+struct edit_transaction
+{
+    int                                         depth = 0;
+    std::unordered_set<net::node_base*>         removals;
+    std::unordered_set<net::parameter_base*>    pushes;
+
+    bool                active() const noexcept { return depth > 0; }
+    void                commit();
+};
+/**                     structural edits buffered between device.beginEdit and device.commit:
+ *                      removed nodes are kept until commit (and reused if re-created meanwhile),
+ *                      value pushes are coalesced and sent once; nodes actually created or removed
+ *                      are still announced one by one by the device signals
+ */
+
+struct protocol_stats
+{
+    explicit            protocol_stats(std::string n) : name(std::move(n)) {}
+
+    std::string                 name;
+    std::atomic<uint64_t>       messages_in { 0 };
+    std::atomic<uint64_t>       messages_out { 0 };
+    std::atomic<uint64_t>       bytes_in { 0 };
+    std::atomic<uint64_t>       bytes_out { 0 };
+    std::atomic<uint64_t>       encode_ns { 0 };
+    std::atomic<uint64_t>       errors { 0 };
+    std::atomic<uint64_t>       dropped { 0 };
+    std::atomic<int64_t>        clients { -1 };
+    std::atomic<int64_t>        queue_depth { -1 };
+
+    // byte counts, queue depth and drops are only seen by the protocols implemented here,
+    // which count their incoming messages themselves
+    bool                        transport = false;
+};
+/**                     counters of one protocol exposed by a multiplexed device,
+ *                      clients and queue_depth stay negative when unknown
+ */
+
+class path_filter
+{
+public:
+                        path_filter(std::vector<std::string> include, std::vector<std::string> exclude);
+
+    bool                allows(const net::node_base& node);
+    bool                matches(const std::string& address) const;
+    void                forget(const net::node_base& node);
+    void                clear();
+
+private:
+    std::vector<std::string>                    m_include;
+    std::vector<std::string>                    m_exclude;
+    std::unordered_map<const net::node_base*, bool> m_cache;
+    std::mutex                                  m_mutex;
+};
+/**                     include / exclude address patterns of one exposed protocol
+ *                      ('*' matches within a level, '**' across levels, '?' one character),
+ *                      evaluated once per node, then cached until the node is removed or renamed
+ */
+
+class counted_protocol final : public net::protocol_base
+{
+public:
+                        counted_protocol(std::unique_ptr<net::protocol_base> protocol,
+                                         std::shared_ptr<protocol_stats> stats,
+                                         std::shared_ptr<path_filter> filter);
+                        ~counted_protocol() override;
+
+    bool                pull(net::parameter_base& parameter) override;
+    std::future<void>   pull_async(net::parameter_base& parameter) override;
+    void                request(net::parameter_base& parameter) override;
+    bool                push(const net::parameter_base& parameter, const ossia::value& v) override;
+    bool                push(const net::parameter_base& parameter, ossia::value&& v) override;
+    bool                push_raw(const net::full_parameter_data& data) override;
+    bool                push_bundle(const std::vector<const net::parameter_base*>& parameters) override;
+    bool                push_raw_bundle(const std::vector<net::full_parameter_data>& data) override;
+    bool                observe(net::parameter_base& parameter, bool enable) override;
+    bool                observe_quietly(net::parameter_base& parameter, bool enable) override;
+    bool                update(net::node_base& node) override;
+    void                set_logger(const net::network_logger& logger) override;
+    const net::network_logger& get_logger() const noexcept override;
+    void                set_device(net::device_base& device) override;
+    void                stop() override;
+
+private:
+    void                on_client_connected(const std::string&);
+    void                on_client_disconnected(const std::string&);
+
+    std::unique_ptr<net::protocol_base>     m_protocol;
+    std::shared_ptr<protocol_stats>         m_stats;
+    std::shared_ptr<path_filter>            m_filter;
+    spdlog::sink_ptr                        m_inbound_counter;
+};
+/**                     forwards every call to the wrapped protocol, timing and counting outgoing
+ *                      messages (and oscquery client connections) into its stats,
+ *                      incoming ones are counted through a sink added to the protocol's inbound
+ *                      logger, parameters outside of its filter (if any) are neither pushed nor observed
+ */
+counted_protocol&       expose(net::device_base& device, std::unique_ptr<net::protocol_base> protocol,
+                               const std::string& kind, std::shared_ptr<protocol_stats> stats = nullptr,
+                               std::shared_ptr<path_filter> filter = nullptr);
+/**                     adds the protocol to the device's multiplex, wrapped in a counted_protocol
+ *                      whose stats are registered as "kind", "kind.1", ...
+ *                      the filter defaults to the one set from sc before the expose call
+ */
+
+struct device_binding
+{
+    explicit            device_binding(net::device_base& device) : index(device), json(device) {}
+                        ~device_binding() { *alive = false; }
+
+    path_index          index;
+    edit_transaction    edit;
+    bool                upsert = false;
+    listen_mode         listen = LISTEN_SELECTIVE;
+    std::unique_ptr<node_pools> pools;
+    std::vector<std::shared_ptr<protocol_stats>> stats;
+    std::vector<std::shared_ptr<path_filter>>    filters;
+    std::shared_ptr<path_filter>                 pending_filter;
+
+    // lazy mirrors: the downloaded remote namespace, materialised on demand,
+    // kept in sync with the device, and the protocol current values are requested from
+    std::shared_ptr<net::generic_device>        shadow;
+    std::unique_ptr<shadow_sync>                sync;
+    std::unordered_set<const net::node_base*>   expanded;
+    net::protocol_base*                         mirror = nullptr;
+
+    // checked by background tasks (under the language lock) before touching the device
+    std::shared_ptr<std::atomic<bool>> alive = std::make_shared<std::atomic<bool>>(true);
+};
+/**                     binding-side state attached to each device created from sc
+ */
+device_binding*         get_binding(const net::device_base& device) noexcept;
+/**                     returns the device's binding state, nullptr for foreign devices
+ */
+
+bool                    lock_language();
+/**                     takes the language lock for completions run from background threads,
+ *                      gives up (returning false, without the lock) once sclang is exiting:
+ *                      the exiting thread may hold it while waiting for these threads
+ */
+void                    finish_thread(std::thread& thread, const std::atomic<bool>& done,
+                                      std::chrono::steady_clock::time_point deadline);
+/**                     joins a background thread on exit, or detaches it if it is still busy
+ *                      at deadline (e.g. blocked on the network or on the language lock)
+ */
+
+class background_jobs
+{
+public:
+                        ~background_jobs();
+    void                run(std::function<void()> job);
+private:
+    struct worker
+    {
+        std::thread                         thread;
+        std::shared_ptr<std::atomic<bool>>  done;
+    };
+
+    std::vector<worker> m_workers;
+    std::mutex          m_mutex;
+};
+/**                     one thread per long-running network task (e.g. mirror loading),
+ *                      finished threads are reaped on the next run, on exit they are
+ *                      joined if they finish in time and detached otherwise
+ */
+
+class zeroconf_browser
+{
+public:
+    using change_callback = std::function<void(const net::zeroconf_server&, bool)>;
+
+                        ~zeroconf_browser();
+    void                start(change_callback on_change);
+    std::vector<net::zeroconf_server> devices();
+private:
+    // shared with the thread, which may outlive the browser if it is detached on exit
+    struct state
+    {
+        std::vector<net::zeroconf_server> devices;
+        change_callback             on_change;
+        std::mutex                  mutex;
+        std::condition_variable     condition;
+        bool                        stop = false;
+        std::atomic<bool>           done { false };
+    };
+
+    static void         run(std::shared_ptr<state> shared);
+
+    std::shared_ptr<state>      m_state = std::make_shared<state>();
+    std::thread                 m_thread;
+};
+/**                     browses oscquery devices on a background thread, keeping a cached list
+ *                      and reporting devices that appear (true) or disappear (false),
+ *                      started on first use and stopped on exit, changes are dropped from then on
+ */
+
+class teardown_queue
+{
+public:
+                        ~teardown_queue();
+    void                push(std::unique_ptr<net::device_base> device,
+                             std::unique_ptr<node_pools> pools,
+                             std::function<void()> done);
+private:
+    struct job
+    {
+        std::unique_ptr<net::device_base>   device;
+        std::unique_ptr<node_pools>         pools;
+        std::function<void()>               done;
+    };
+
+    // shared with the thread, which may outlive the queue if it is detached on exit
+    struct state
+    {
+        std::deque<job>             jobs;
+        std::mutex                  mutex;
+        std::condition_variable     condition;
+        bool                        stop = false;
+        std::atomic<bool>           done { false };
+    };
+
+    static void         run(std::shared_ptr<state> shared);
+
+    std::shared_ptr<state>      m_state = std::make_shared<state>();
+    std::thread                 m_thread;
+};
+/**                     destroys detached devices (and their protocols) on a background thread,
+ *                      on exit completions are dropped and pending devices are destroyed
+ *                      if time allows, the thread is detached otherwise
+ */
+
+#ifdef OSSIA_SC_DATAGRAM_SOCKETS
+class batched_osc_protocol final : public net::protocol_base
+{
+public:
+    static constexpr std::size_t BATCH_SIZE = 64;
+    static constexpr std::size_t DATAGRAM_SIZE = 2048;
+
+                        batched_osc_protocol(const std::string& remote_ip,
+                                             uint16_t remote_port, uint16_t local_port,
+                                             std::shared_ptr<protocol_stats> stats);
+                        batched_osc_protocol(const std::string& local_path,
+                                             const std::string& remote_path,
+                                             std::shared_ptr<protocol_stats> stats);
+                        ~batched_osc_protocol() override;
+
+    bool                pull(net::parameter_base&) override { return false; }
+    bool                push(const net::parameter_base& parameter, const ossia::value& v) override;
+    bool                push_raw(const net::full_parameter_data& data) override;
+    bool                observe(net::parameter_base&, bool) override { return false; }
+    bool                update(net::node_base&) override { return false; }
+    void                set_device(net::device_base& device) override { m_device = &device; }
+
+private:
+    struct datagram
+    {
+        std::size_t     size = 0;
+        char            data[DATAGRAM_SIZE];
+    };
+
+    void                open(int family, const sockaddr* local, socklen_t length);
+    bool                enqueue(const std::string& address, const ossia::value& v,
+                                bool filter_repetitions = false);
+    void                receive();
+    void                send();
+    void                dispatch(const char* data, std::size_t size);
+
+    net::device_base*           m_device = nullptr;
+    std::shared_ptr<protocol_stats> m_stats;
+    int                         m_socket = -1;
+    sockaddr_storage            m_remote {};
+    socklen_t                   m_remote_length = 0;
+    std::string                 m_local_path;
+    std::string                 m_remote_name;
+    std::vector<datagram>       m_inbox;
+    std::vector<datagram>       m_outbox;
+    std::size_t                 m_pending = 0;
+    std::unordered_map<std::string, ossia::value> m_last_pushed;
+    std::mutex                  m_mutex;
+    std::condition_variable     m_condition;
+    std::atomic<bool>           m_stop { false };
+    bool                        m_unreachable = false;
+    std::thread                 m_receiver;
+    std::thread                 m_sender;
+};
+/**                     plain osc over udp, or over unix datagram sockets for local peers,
+ *                      reading and writing up to BATCH_SIZE datagrams per syscall on linux
+ *                      (recvmmsg / sendmmsg, one per datagram elsewhere) into preallocated buffers,
+ *                      pushes are queued and flushed together by the sender thread, neither
+ *                      of which ever blocks: pushes to a full queue and sends the socket can't
+ *                      take right away are dropped and counted,
+ *                      access modes, bounding and repetition filters apply both ways
+ */
+#endif
+
+struct footprint
+{
+    std::size_t         nodes = 0;
+    std::size_t         parameters = 0;
+    std::size_t         callbacks = 0;
+    std::size_t         protocols = 0;
+    std::size_t         node_bytes = 0;
+    std::size_t         value_bytes = 0;
+    std::size_t         attribute_bytes = 0;
+    std::size_t         binding_bytes = 0;
+    std::size_t         pool_bytes = 0;
+};
+/**                     estimated memory usage of a device or subtree, byte counts are
+ *                      approximations from object sizes and container capacities
+ */
+footprint               measure_footprint(net::node_base& root);
+/**                     walks the subtree and sums up its footprint
+ */
+std::size_t             value_footprint(const ossia::value& value) noexcept;
+/**                     returns the heap bytes held by a value, including nested lists and strings
+ */
+
+#ifdef OSSIA_ALLOC_DEBUG
+struct alloc_record
+{
+    std::size_t         calls = 0;
+    std::size_t         allocations = 0;
+    std::size_t         bytes = 0;
+};
+/**                     allocations made on the calling thread while a primitive runs
+ */
+class alloc_scope
+{
+public:
+    explicit            alloc_scope(alloc_record& record) noexcept;
+                        ~alloc_scope();
+private:
+    alloc_record*       m_previous;
+};
+/**                     routes the thread's allocations to a record while alive,
+ *                      only active when allocation tracking was enabled from sc
+ */
+#endif
+
 class ex_node_undef :   public std::exception {
 public:                 virtual const char* what() const throw() final; };
 /**                     exception: in case ossia node cannot be found on the stack
@@ -57,11 +725,49 @@ template<class T> int   check_argument_reference
 /**                     returns target's enum index if argument matches the list
  *                      returns -1 otherwise
  */
-void                    register_sc_node(pyrslot *s, net::node_base *node) noexcept;
-/**                     saves the node on the stack
+void                    register_sc_node(pyrslot *s, net::node_base *node);
+/**                     saves the node's handle in the sc object
  */
 net::node_base*         get_node(pyrslot *s);
-/**                     returns slot's matching ossia::node
+/**                     returns slot's matching ossia::node,
+ *                      throws if the object is not a node or its handle is stale
+ */
+net::parameter_base*    get_parameter(pyrslot *s);
+/**                     returns the parameter of the slot's node,
+ *                      throws if the node is gone or no longer has a parameter
+ */
+net::generic_device&    get_device(pyrslot *s);
+net::multiplex_protocol& get_multiplex(pyrslot *s);
+/**                     returns the device (or its multiplex protocol) of an OSSIA_Device slot,
+ *                      throws if the slot is not a live device
+ */
+PyrSymbol*              parameter_symbol(net::node_base& node);
+/**                     returns the node's unique synth-argument symbol (name_address),
+ *                      built once and cached until the node is removed
+ */
+net::node_base&         create_child(net::node_base& parent, const std::string& name);
+/**                     creates a node under parent, from the device's pools in pool allocation mode,
+ *                      names containing '/' create intermediate nodes as needed
+ */
+void                    expand(net::node_base& node, int depth = 1);
+/**                     lazy mirrors: creates the node's children (down to depth levels, -1 for all)
+ *                      from the downloaded remote namespace, if not done already,
+ *                      and requests the current value of their parameters
+ */
+void                    set_shadow(device_binding& binding, net::device_base& device,
+                                   std::shared_ptr<net::generic_device> shadow);
+/**                     replaces a lazy mirror's remote namespace, and the sync that keeps it up to date
+ */
+net::node_base*         find_node(net::node_base& origin, const std::string& address);
+/**                     resolves an address relative to origin through its device's path index,
+ *                      returns nullptr if no such node exists
+ */
+void                    forget_subtree(net::node_base& node) noexcept;
+/**                     drops cached binding-side data for the node and all its children
+ */
+void                    forget_parameter(net::parameter_base& parameter) noexcept;
+/**                     drops binding-side data for a parameter about to be removed
+ *                      (sc callbacks, pending pushes, remote subscription), node kept or not
  */
 template<class T>
 std::string             format_listed_attribute
@@ -82,6 +788,9 @@ void                    write_string(vmglobals *g, pyrslot *target, const std::s
 void                    write_value(vmglobals *g, pyrslot *target, const ossia::value& value) noexcept;
 /**                     writes an ossia value to a sc slot
  */
+void                    write_symbol(vmglobals *g, pyrslot *target, const std::string& string) noexcept;
+/**                     writes an std::string to a sc slot as an interned Symbol
+ */
 std::string             read_classname(pyrslot* s) noexcept;
 /**                     returns slot's classname as std::string, safe function
  */
@@ -94,6 +803,28 @@ template<class T> T     read_listed_attribute
 value                   read_value(pyrslot *s);
 val_type                read_type(pyrslot *s);
 domain                  read_domain(pyrslot *s, val_type t);
+uint8_t                 read_columns(pyrslot *s);
+explore_filter          read_filter(pyrslot *s);
+parameter_spec          read_parameter_spec(pyrslot *type, pyrslot *domain, pyrslot *default_value,
+                                            pyrslot *bounding_mode, pyrslot *critical, pyrslot *repetition_filter);
+subtree_template        read_template(pyrslot *s);
+/**                     parses an array of [path] or [path, type, domain, default_value,
+ *                      bounding_mode, critical, repetition_filter, unit] entries
+ */
+net::parameter_base*    apply_parameter_spec(net::node_base& node, const parameter_spec& spec);
+/**                     creates the node's parameter from spec, pushing its default value
+ *                      (or deferring the push to the end of the device's transaction)
+ */
+net::parameter_base*    upsert_parameter(net::node_base& node, const parameter_spec& spec);
+/**                     updates the node's existing parameter in place, only setting attributes
+ *                      that differ from spec, creates it if there is none
+ */
+void                    update_listening(net::parameter_base& parameter);
+/**                     (un)subscribes the parameter on the device's remote, according to its listen mode
+ */
+void                    push_parameter(net::parameter_base& parameter);
+/**                     pushes the parameter's value to the network, or defers it during a transaction
+ */
 unit_t                  read_unit(pyrslot *s);
 /**                     sc slot to ossia node attributes
  */
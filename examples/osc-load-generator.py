@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+"""
+External OSC load generator for osc-batch-benchmark.scd.
+
+Floods a UDP port with integer messages addressed to /param.<i>, then waits for the
+receiving process to go idle, and reports the CPU time it used meanwhile (user and system,
+read from /proc) along with its context switches. With --strace, the receiver's network
+syscalls are counted too (strace slows it down a lot: don't compare CPU figures of such runs).
+
+    python3 osc-load-generator.py --pid <sclang pid> --port 9000 --messages 200000
+"""
+
+import argparse
+import os
+import signal
+import socket
+import struct
+import subprocess
+import sys
+import time
+
+
+def osc_string(s):
+    data = s.encode() + b"\0"
+    return data + b"\0" * (-len(data) % 4)
+
+
+def osc_message(address, value):
+    return osc_string(address) + osc_string(",i") + struct.pack(">i", value)
+
+
+def process_usage(pid):
+    # utime and stime are the 14th and 15th fields, counted after the parenthesised command name
+    with open("/proc/%d/stat" % pid) as f:
+        fields = f.read().rsplit(")", 1)[1].split()
+    ticks = os.sysconf("SC_CLK_TCK")
+    usage = {"user": int(fields[11]) / ticks, "system": int(fields[12]) / ticks}
+
+    with open("/proc/%d/status" % pid) as f:
+        for line in f:
+            if line.startswith("voluntary_ctxt_switches"):
+                usage["voluntary switches"] = int(line.split()[1])
+            elif line.startswith("nonvoluntary_ctxt_switches"):
+                usage["involuntary switches"] = int(line.split()[1])
+    return usage
+
+
+def wait_idle(pid, timeout, period=0.25, threshold=0.01):
+    # the receiver is done once a whole period goes by without it using any noticeable cpu
+    start = time.monotonic()
+    last = process_usage(pid)
+    while time.monotonic() - start < timeout:
+        time.sleep(period)
+        current = process_usage(pid)
+        busy = (current["user"] + current["system"]) - (last["user"] + last["system"])
+        last = current
+        if busy < threshold:
+            return True
+    return False
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--pid", type=int, required=True, help="pid of the receiving sclang")
+    parser.add_argument("--host", default="127.0.0.1")
+    parser.add_argument("--port", type=int, required=True)
+    parser.add_argument("--messages", type=int, default=200000)
+    parser.add_argument("--params", type=int, default=100)
+    parser.add_argument("--rate", type=float, default=0, help="messages per second, 0 for as fast as possible")
+    parser.add_argument("--timeout", type=float, default=30, help="seconds to wait for the receiver to go idle")
+    parser.add_argument("--strace", action="store_true", help="count the receiver's network syscalls")
+    args = parser.parse_args()
+
+    target = (args.host, args.port)
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    packets = [osc_message("/param.%d" % (i % args.params), i) for i in range(args.messages)]
+
+    tracer = None
+    if args.strace:
+        tracer = subprocess.Popen(["strace", "-c", "-f", "-e", "trace=network", "-p", str(args.pid)],
+                                  stderr=subprocess.PIPE, universal_newlines=True)
+        time.sleep(1)
+
+    before = process_usage(args.pid)
+    start = time.monotonic()
+
+    for i, packet in enumerate(packets):
+        sock.sendto(packet, target)
+        if args.rate > 0:
+            delay = start + (i + 1) / args.rate - time.monotonic()
+            if delay > 0:
+                time.sleep(delay)
+
+    sent = time.monotonic() - start
+    idle = wait_idle(args.pid, args.timeout)
+    after = process_usage(args.pid)
+
+    print("sent %d messages in %.3f s (%d msg/s)" % (args.messages, sent, args.messages / sent))
+    if not idle:
+        print("warning: the receiver was still busy after %g s, figures include other work" % args.timeout)
+
+    for key in ("user", "system"):
+        print("receiver %s cpu: %.3f s" % (key, after[key] - before[key]))
+    cpu = (after["user"] + after["system"]) - (before["user"] + before["system"])
+    print("receiver cpu per message: %.2f us" % (cpu / args.messages * 1e6))
+    for key in ("voluntary switches", "involuntary switches"):
+        if key in after:
+            print("receiver %s: %d" % (key, after[key] - before[key]))
+
+    if tracer:
+        tracer.send_signal(signal.SIGINT)
+        print(tracer.communicate()[1])
+
+    print("now evaluate ~report in sclang for the received counts")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())